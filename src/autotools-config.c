@@ -33,6 +33,21 @@ struct _AutotoolsConfigPrivate
   gchar             *configure_file;
   gchar             *configure_parameters;
   gchar             *build_folder;
+  gint               scrollback_lines;
+  gint               scrollback_chars;
+  AutotoolsDuplicateBuild duplicate_build;
+  gint               jobs;
+  gdouble            load_average;
+  gchar            **depends_on;
+  AutotoolsConfigureCache configure_cache;
+  gchar             *compiler_launcher;
+  gboolean           build_on_save;
+  gint               build_on_save_delay;
+  gboolean           profile_targets;
+  gchar            **environment;
+  gchar             *name;
+  GList             *configurations;
+  gchar            **active_configurations;
 };
 
 enum
@@ -63,6 +78,21 @@ autotools_config_init (AutotoolsConfig *config)
   priv->configure_file = NULL;
   priv->configure_parameters = NULL;
   priv->build_folder = NULL;
+  priv->scrollback_lines = 0;
+  priv->scrollback_chars = 0;
+  priv->duplicate_build = AUTOTOOLS_DUPLICATE_BUILD_MERGE;
+  priv->jobs = 0;
+  priv->load_average = 0;
+  priv->depends_on = NULL;
+  priv->configure_cache = AUTOTOOLS_CONFIGURE_CACHE_NONE;
+  priv->compiler_launcher = NULL;
+  priv->build_on_save = FALSE;
+  priv->build_on_save_delay = AUTOTOOLS_CONFIG_DEFAULT_BUILD_ON_SAVE_DELAY;
+  priv->profile_targets = FALSE;
+  priv->environment = NULL;
+  priv->name = NULL;
+  priv->configurations = NULL;
+  priv->active_configurations = NULL;
 }
 
 static void
@@ -85,6 +115,36 @@ autotools_config_finalize (AutotoolsConfig *config)
       g_free (priv->build_folder);
       priv->build_folder = NULL;
     }
+  if (priv->compiler_launcher)
+    {
+      g_free (priv->compiler_launcher);
+      priv->compiler_launcher = NULL;
+    }
+  if (priv->depends_on)
+    {
+      g_strfreev (priv->depends_on);
+      priv->depends_on = NULL;
+    }
+  if (priv->environment)
+    {
+      g_strfreev (priv->environment);
+      priv->environment = NULL;
+    }
+  if (priv->name)
+    {
+      g_free (priv->name);
+      priv->name = NULL;
+    }
+  if (priv->configurations)
+    {
+      g_list_free_full (priv->configurations, g_object_unref);
+      priv->configurations = NULL;
+    }
+  if (priv->active_configurations)
+    {
+      g_strfreev (priv->active_configurations);
+      priv->active_configurations = NULL;
+    }
   G_OBJECT_CLASS (autotools_config_parent_class)->finalize (G_OBJECT (config));
 }
 
@@ -170,3 +230,262 @@ autotools_config_set_build_folder (AutotoolsConfig *config,
     }
   priv->build_folder = g_strdup (build_folder);
 }
+
+gint
+autotools_config_get_scrollback_lines (AutotoolsConfig *config)
+{
+  return AUTOTOOLS_CONFIG_GET_PRIVATE (config)->scrollback_lines;
+}
+
+void
+autotools_config_set_scrollback_lines (AutotoolsConfig *config,
+                                       gint             scrollback_lines)
+{
+  AutotoolsConfigPrivate *priv;
+  priv = AUTOTOOLS_CONFIG_GET_PRIVATE (config);
+  priv->scrollback_lines = scrollback_lines;
+}
+
+gint
+autotools_config_get_scrollback_chars (AutotoolsConfig *config)
+{
+  return AUTOTOOLS_CONFIG_GET_PRIVATE (config)->scrollback_chars;
+}
+
+void
+autotools_config_set_scrollback_chars (AutotoolsConfig *config,
+                                       gint             scrollback_chars)
+{
+  AutotoolsConfigPrivate *priv;
+  priv = AUTOTOOLS_CONFIG_GET_PRIVATE (config);
+  priv->scrollback_chars = scrollback_chars;
+}
+
+AutotoolsDuplicateBuild
+autotools_config_get_duplicate_build (AutotoolsConfig *config)
+{
+  return AUTOTOOLS_CONFIG_GET_PRIVATE (config)->duplicate_build;
+}
+
+void
+autotools_config_set_duplicate_build (AutotoolsConfig         *config,
+                                      AutotoolsDuplicateBuild  duplicate_build)
+{
+  AutotoolsConfigPrivate *priv;
+  priv = AUTOTOOLS_CONFIG_GET_PRIVATE (config);
+  priv->duplicate_build = duplicate_build;
+}
+
+gint
+autotools_config_get_jobs (AutotoolsConfig *config)
+{
+  return AUTOTOOLS_CONFIG_GET_PRIVATE (config)->jobs;
+}
+
+void
+autotools_config_set_jobs (AutotoolsConfig *config,
+                           gint             jobs)
+{
+  AutotoolsConfigPrivate *priv;
+  priv = AUTOTOOLS_CONFIG_GET_PRIVATE (config);
+  priv->jobs = MAX (jobs, 0);
+}
+
+gdouble
+autotools_config_get_load_average (AutotoolsConfig *config)
+{
+  return AUTOTOOLS_CONFIG_GET_PRIVATE (config)->load_average;
+}
+
+void
+autotools_config_set_load_average (AutotoolsConfig *config,
+                                   gdouble          load_average)
+{
+  AutotoolsConfigPrivate *priv;
+  priv = AUTOTOOLS_CONFIG_GET_PRIVATE (config);
+  priv->load_average = load_average > 0 ? load_average : 0;
+}
+
+gchar**
+autotools_config_get_depends_on (AutotoolsConfig *config)
+{
+  return AUTOTOOLS_CONFIG_GET_PRIVATE (config)->depends_on;
+}
+
+void
+autotools_config_set_depends_on (AutotoolsConfig  *config,
+                                 gchar           **depends_on)
+{
+  AutotoolsConfigPrivate *priv;
+  priv = AUTOTOOLS_CONFIG_GET_PRIVATE (config);
+  if (priv->depends_on)
+    g_strfreev (priv->depends_on);
+  priv->depends_on = g_strdupv (depends_on);
+}
+
+AutotoolsConfigureCache
+autotools_config_get_configure_cache (AutotoolsConfig *config)
+{
+  return AUTOTOOLS_CONFIG_GET_PRIVATE (config)->configure_cache;
+}
+
+void
+autotools_config_set_configure_cache (AutotoolsConfig         *config,
+                                      AutotoolsConfigureCache  configure_cache)
+{
+  AutotoolsConfigPrivate *priv;
+  priv = AUTOTOOLS_CONFIG_GET_PRIVATE (config);
+  priv->configure_cache = configure_cache;
+}
+
+const gchar*
+autotools_config_get_compiler_launcher (AutotoolsConfig *config)
+{
+  return AUTOTOOLS_CONFIG_GET_PRIVATE (config)->compiler_launcher;
+}
+
+void
+autotools_config_set_compiler_launcher (AutotoolsConfig *config,
+                                        const gchar     *compiler_launcher)
+{
+  AutotoolsConfigPrivate *priv;
+  priv = AUTOTOOLS_CONFIG_GET_PRIVATE (config);
+  if (priv->compiler_launcher)
+    {
+      g_free (priv->compiler_launcher);
+      priv->compiler_launcher = NULL;
+    }
+  priv->compiler_launcher = g_strdup (compiler_launcher);
+}
+
+gboolean
+autotools_config_get_build_on_save (AutotoolsConfig *config)
+{
+  return AUTOTOOLS_CONFIG_GET_PRIVATE (config)->build_on_save;
+}
+
+void
+autotools_config_set_build_on_save (AutotoolsConfig *config,
+                                    gboolean         build_on_save)
+{
+  AutotoolsConfigPrivate *priv;
+  priv = AUTOTOOLS_CONFIG_GET_PRIVATE (config);
+  priv->build_on_save = build_on_save;
+}
+
+gint
+autotools_config_get_build_on_save_delay (AutotoolsConfig *config)
+{
+  return AUTOTOOLS_CONFIG_GET_PRIVATE (config)->build_on_save_delay;
+}
+
+void
+autotools_config_set_build_on_save_delay (AutotoolsConfig *config,
+                                          gint             build_on_save_delay)
+{
+  AutotoolsConfigPrivate *priv;
+  priv = AUTOTOOLS_CONFIG_GET_PRIVATE (config);
+  if (build_on_save_delay > 0)
+    priv->build_on_save_delay = build_on_save_delay;
+  else
+    priv->build_on_save_delay = AUTOTOOLS_CONFIG_DEFAULT_BUILD_ON_SAVE_DELAY;
+}
+
+gboolean
+autotools_config_get_profile_targets (AutotoolsConfig *config)
+{
+  return AUTOTOOLS_CONFIG_GET_PRIVATE (config)->profile_targets;
+}
+
+void
+autotools_config_set_profile_targets (AutotoolsConfig *config,
+                                      gboolean         profile_targets)
+{
+  AutotoolsConfigPrivate *priv;
+  priv = AUTOTOOLS_CONFIG_GET_PRIVATE (config);
+  priv->profile_targets = profile_targets;
+}
+
+gchar**
+autotools_config_get_environment (AutotoolsConfig *config)
+{
+  return AUTOTOOLS_CONFIG_GET_PRIVATE (config)->environment;
+}
+
+void
+autotools_config_set_environment (AutotoolsConfig  *config,
+                                  gchar           **environment)
+{
+  AutotoolsConfigPrivate *priv;
+  priv = AUTOTOOLS_CONFIG_GET_PRIVATE (config);
+  if (priv->environment)
+    g_strfreev (priv->environment);
+  priv->environment = g_strdupv (environment);
+}
+
+const gchar*
+autotools_config_get_name (AutotoolsConfig *config)
+{
+  return AUTOTOOLS_CONFIG_GET_PRIVATE (config)->name;
+}
+
+void
+autotools_config_set_name (AutotoolsConfig *config,
+                           const gchar     *name)
+{
+  AutotoolsConfigPrivate *priv;
+  priv = AUTOTOOLS_CONFIG_GET_PRIVATE (config);
+  if (priv->name)
+    g_free (priv->name);
+  priv->name = g_strdup (name);
+}
+
+GList*
+autotools_config_get_configurations (AutotoolsConfig *config)
+{
+  return AUTOTOOLS_CONFIG_GET_PRIVATE (config)->configurations;
+}
+
+void
+autotools_config_set_configurations (AutotoolsConfig *config,
+                                     GList           *configurations)
+{
+  AutotoolsConfigPrivate *priv;
+  GList *list;
+  priv = AUTOTOOLS_CONFIG_GET_PRIVATE (config);
+  for (list = configurations; list != NULL; list = list->next)
+    g_object_ref (list->data);
+  if (priv->configurations)
+    g_list_free_full (priv->configurations, g_object_unref);
+  priv->configurations = g_list_copy (configurations);
+}
+
+AutotoolsConfig*
+autotools_config_get_configuration (AutotoolsConfig *config,
+                                    const gchar     *name)
+{
+  AutotoolsConfigPrivate *priv;
+  GList *list;
+  priv = AUTOTOOLS_CONFIG_GET_PRIVATE (config);
+  for (list = priv->configurations; list != NULL; list = list->next)
+    if (g_strcmp0 (autotools_config_get_name (list->data), name) == 0)
+      return list->data;
+  return NULL;
+}
+
+gchar**
+autotools_config_get_active_configurations (AutotoolsConfig *config)
+{
+  return AUTOTOOLS_CONFIG_GET_PRIVATE (config)->active_configurations;
+}
+
+void
+autotools_config_set_active_configurations (AutotoolsConfig  *config,
+                                            gchar           **active_configurations)
+{
+  AutotoolsConfigPrivate *priv;
+  priv = AUTOTOOLS_CONFIG_GET_PRIVATE (config);
+  if (priv->active_configurations)
+    g_strfreev (priv->active_configurations);
+  priv->active_configurations = g_strdupv (active_configurations);
+}
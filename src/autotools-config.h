@@ -30,6 +30,21 @@ G_BEGIN_DECLS
 #define IS_AUTOTOOLS_CONFIG(obj)         (G_TYPE_CHECK_INSTANCE_TYPE ((obj), AUTOTOOLS_CONFIG_TYPE))
 #define IS_AUTOTOOLS_CONFIG_CLASS(klass) (G_TYPE_CHECK_CLASS_TYPE ((klass), AUTOTOOLS_CONFIG_TYPE))
 
+typedef enum
+{
+  AUTOTOOLS_DUPLICATE_BUILD_MERGE,
+  AUTOTOOLS_DUPLICATE_BUILD_RESTART
+} AutotoolsDuplicateBuild;
+
+typedef enum
+{
+  AUTOTOOLS_CONFIGURE_CACHE_NONE,
+  AUTOTOOLS_CONFIGURE_CACHE_PROJECT,
+  AUTOTOOLS_CONFIGURE_CACHE_SHARED
+} AutotoolsConfigureCache;
+
+#define AUTOTOOLS_CONFIG_DEFAULT_BUILD_ON_SAVE_DELAY 1000
+
 typedef struct _AutotoolsConfig AutotoolsConfig;
 typedef struct _AutotoolsConfigClass AutotoolsConfigClass;
 
@@ -59,6 +74,53 @@ void                      autotools_config_set_configure_parameters  (AutotoolsC
 const gchar*              autotools_config_get_build_folder          (AutotoolsConfig *config);
 void                      autotools_config_set_build_folder          (AutotoolsConfig *config,
                                                                       const gchar     *build_folder);
+gint                      autotools_config_get_scrollback_lines      (AutotoolsConfig *config);
+void                      autotools_config_set_scrollback_lines      (AutotoolsConfig *config,
+                                                                      gint             scrollback_lines);
+gint                      autotools_config_get_scrollback_chars      (AutotoolsConfig *config);
+void                      autotools_config_set_scrollback_chars      (AutotoolsConfig *config,
+                                                                      gint             scrollback_chars);
+AutotoolsDuplicateBuild   autotools_config_get_duplicate_build       (AutotoolsConfig *config);
+void                      autotools_config_set_duplicate_build       (AutotoolsConfig *config,
+                                                                      AutotoolsDuplicateBuild duplicate_build);
+gint                      autotools_config_get_jobs                  (AutotoolsConfig *config);
+void                      autotools_config_set_jobs                  (AutotoolsConfig *config,
+                                                                      gint             jobs);
+gdouble                   autotools_config_get_load_average          (AutotoolsConfig *config);
+void                      autotools_config_set_load_average          (AutotoolsConfig *config,
+                                                                      gdouble          load_average);
+AutotoolsConfigureCache   autotools_config_get_configure_cache       (AutotoolsConfig *config);
+void                      autotools_config_set_configure_cache       (AutotoolsConfig *config,
+                                                                      AutotoolsConfigureCache configure_cache);
+const gchar*              autotools_config_get_compiler_launcher     (AutotoolsConfig *config);
+void                      autotools_config_set_compiler_launcher     (AutotoolsConfig *config,
+                                                                      const gchar     *compiler_launcher);
+gboolean                  autotools_config_get_build_on_save         (AutotoolsConfig *config);
+void                      autotools_config_set_build_on_save         (AutotoolsConfig *config,
+                                                                      gboolean         build_on_save);
+gint                      autotools_config_get_build_on_save_delay   (AutotoolsConfig *config);
+void                      autotools_config_set_build_on_save_delay   (AutotoolsConfig *config,
+                                                                      gint             build_on_save_delay);
+gboolean                  autotools_config_get_profile_targets       (AutotoolsConfig *config);
+void                      autotools_config_set_profile_targets       (AutotoolsConfig *config,
+                                                                      gboolean         profile_targets);
+gchar**                   autotools_config_get_environment           (AutotoolsConfig *config);
+void                      autotools_config_set_environment           (AutotoolsConfig *config,
+                                                                      gchar          **environment);
+const gchar*              autotools_config_get_name                  (AutotoolsConfig *config);
+void                      autotools_config_set_name                  (AutotoolsConfig *config,
+                                                                      const gchar     *name);
+GList*                    autotools_config_get_configurations        (AutotoolsConfig *config);
+void                      autotools_config_set_configurations        (AutotoolsConfig *config,
+                                                                      GList           *configurations);
+AutotoolsConfig*          autotools_config_get_configuration         (AutotoolsConfig *config,
+                                                                      const gchar     *name);
+gchar**                   autotools_config_get_active_configurations (AutotoolsConfig *config);
+void                      autotools_config_set_active_configurations (AutotoolsConfig *config,
+                                                                      gchar          **active_configurations);
+gchar**                   autotools_config_get_depends_on            (AutotoolsConfig *config);
+void                      autotools_config_set_depends_on            (AutotoolsConfig *config,
+                                                                      gchar          **depends_on);
 
 G_END_DECLS
 
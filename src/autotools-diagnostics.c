@@ -0,0 +1,815 @@
+/*
+ * Copyright (C) 2010 - Jeff Johnston
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+ */
+
+#include <string.h>
+#include "autotools-diagnostics.h"
+
+typedef struct
+{
+  const gchar *text;
+  gsize        length;
+  guint32      severity;
+} Keyword;
+
+typedef struct
+{
+  gchar   *name;
+  guint32 *directories;
+  guint    n_directories;
+} File;
+
+static void autotools_diagnostics_class_init  (AutotoolsDiagnosticsClass *klass);
+static void autotools_diagnostics_init        (AutotoolsDiagnostics      *diagnostics);
+static void autotools_diagnostics_finalize    (AutotoolsDiagnostics      *diagnostics);
+
+static void scan_line                         (AutotoolsDiagnostics      *diagnostics,
+                                               const gchar               *line,
+                                               gsize                      length);
+static gboolean scan_make_line                (AutotoolsDiagnostics      *diagnostics,
+                                               const gchar               *line,
+                                               const gchar               *end);
+static gboolean scan_directory_line           (AutotoolsDiagnostics      *diagnostics,
+                                               const gchar               *p,
+                                               const gchar               *end,
+                                               guint32                    level);
+static guint32 intern_directory               (AutotoolsDiagnostics      *diagnostics,
+                                               const gchar               *path,
+                                               gsize                      length);
+static const gchar* scan_location             (const gchar               *p,
+                                               const gchar               *end,
+                                               guint32                   *line_number,
+                                               guint32                   *column);
+static const gchar* scan_number               (const gchar               *p,
+                                               const gchar               *end,
+                                               guint32                   *number);
+static gint scan_keyword                      (const gchar               *p,
+                                               const gchar               *end);
+static void add_diagnostic                    (AutotoolsDiagnostics      *diagnostics,
+                                               const gchar               *line,
+                                               const gchar               *start,
+                                               const gchar               *end,
+                                               const gchar               *file_end,
+                                               guint32                    line_number,
+                                               guint32                    column,
+                                               guint32                    severity);
+static guint32 intern_file                    (AutotoolsDiagnostics      *diagnostics,
+                                               const gchar               *file,
+                                               gsize                      length);
+static gchar* join_path                       (const gchar               *directory,
+                                               const gchar               *file);
+static void free_file                         (File                      *file);
+static gint count_chars                       (const gchar               *text,
+                                               gsize                      length);
+
+#define CHAR_DIGIT 1
+#define CHAR_PATH  2
+#define MAX_MAKE_LEVEL 64
+
+static guint8 char_table[256];
+
+static const Keyword keywords[] = {
+  { "error:", 6, AUTOTOOLS_DIAGNOSTIC_ERROR },
+  { "fatal error:", 12, AUTOTOOLS_DIAGNOSTIC_ERROR },
+  { "internal compiler error:", 24, AUTOTOOLS_DIAGNOSTIC_ERROR },
+  { "warning:", 8, AUTOTOOLS_DIAGNOSTIC_WARNING },
+  { "note:", 5, AUTOTOOLS_DIAGNOSTIC_NOTE }
+};
+
+static const Keyword include_prefixes[] = {
+  { "In file included from ", 22, AUTOTOOLS_DIAGNOSTIC_NOTE },
+  { "                 from ", 22, AUTOTOOLS_DIAGNOSTIC_NOTE }
+};
+
+#define AUTOTOOLS_DIAGNOSTICS_GET_PRIVATE(obj) \
+  (G_TYPE_INSTANCE_GET_PRIVATE ((obj), AUTOTOOLS_DIAGNOSTICS_TYPE, AutotoolsDiagnosticsPrivate))
+
+typedef struct _AutotoolsDiagnosticsPrivate AutotoolsDiagnosticsPrivate;
+
+struct _AutotoolsDiagnosticsPrivate
+{
+  GArray     *records;
+  GPtrArray  *files;
+  GHashTable *file_ids;
+  GString    *carry;
+  gint64      offset;
+  GPtrArray  *directories;
+  GHashTable *directory_ids;
+  GPtrArray  *levels;
+};
+
+G_DEFINE_TYPE (AutotoolsDiagnostics, autotools_diagnostics, G_TYPE_OBJECT)
+
+static void
+autotools_diagnostics_class_init (AutotoolsDiagnosticsClass *klass)
+{
+  GObjectClass *gobject_class = G_OBJECT_CLASS (klass);
+  const gchar *path_chars = "/._-+~@%";
+  gint i;
+
+  for (i = 0; i < 256; i++)
+    {
+      if (g_ascii_isdigit (i))
+        char_table[i] = CHAR_DIGIT | CHAR_PATH;
+      else if (g_ascii_isalpha (i) || (i != '\0' && strchr (path_chars, i) != NULL))
+        char_table[i] = CHAR_PATH;
+      else
+        char_table[i] = 0;
+    }
+
+  gobject_class->finalize = (GObjectFinalizeFunc) autotools_diagnostics_finalize;
+  g_type_class_add_private (klass, sizeof (AutotoolsDiagnosticsPrivate));
+}
+
+static void
+autotools_diagnostics_init (AutotoolsDiagnostics *diagnostics)
+{
+  AutotoolsDiagnosticsPrivate *priv;
+  priv = AUTOTOOLS_DIAGNOSTICS_GET_PRIVATE (diagnostics);
+  priv->records = g_array_new (FALSE, FALSE, sizeof (AutotoolsDiagnostic));
+  priv->files = g_ptr_array_new_with_free_func ((GDestroyNotify) free_file);
+  priv->file_ids = g_hash_table_new_full (g_str_hash, g_str_equal, g_free, NULL);
+  priv->carry = g_string_new (NULL);
+  priv->offset = 0;
+  priv->directories = g_ptr_array_new_with_free_func (g_free);
+  priv->directory_ids = g_hash_table_new (g_str_hash, g_str_equal);
+  priv->levels = g_ptr_array_new_with_free_func ((GDestroyNotify) g_array_unref);
+}
+
+static void
+autotools_diagnostics_finalize (AutotoolsDiagnostics *diagnostics)
+{
+  AutotoolsDiagnosticsPrivate *priv;
+  priv = AUTOTOOLS_DIAGNOSTICS_GET_PRIVATE (diagnostics);
+  g_array_free (priv->records, TRUE);
+  g_hash_table_destroy (priv->file_ids);
+  g_ptr_array_free (priv->files, TRUE);
+  g_string_free (priv->carry, TRUE);
+  g_hash_table_destroy (priv->directory_ids);
+  g_ptr_array_free (priv->directories, TRUE);
+  g_ptr_array_free (priv->levels, TRUE);
+  G_OBJECT_CLASS (autotools_diagnostics_parent_class)->finalize (G_OBJECT (diagnostics));
+}
+
+AutotoolsDiagnostics*
+autotools_diagnostics_new (void)
+{
+  return AUTOTOOLS_DIAGNOSTICS (g_object_new (autotools_diagnostics_get_type (), NULL));
+}
+
+void
+autotools_diagnostics_clear (AutotoolsDiagnostics *diagnostics)
+{
+  AutotoolsDiagnosticsPrivate *priv;
+  priv = AUTOTOOLS_DIAGNOSTICS_GET_PRIVATE (diagnostics);
+  g_array_set_size (priv->records, 0);
+  g_hash_table_remove_all (priv->file_ids);
+  g_ptr_array_set_size (priv->files, 0);
+  g_string_truncate (priv->carry, 0);
+  priv->offset = 0;
+  g_hash_table_remove_all (priv->directory_ids);
+  g_ptr_array_set_size (priv->directories, 0);
+  g_ptr_array_set_size (priv->levels, 0);
+}
+
+/*
+ * The text is fed in as it arrives, in whatever size chunks the reader 
+ * happens to produce. Lines are found with memchr, which libc vectorizes, 
+ * and the tail of a chunk without a newline is carried over to the next 
+ * call. Returns the index of the first diagnostic added by this chunk.
+ */
+guint
+autotools_diagnostics_scan (AutotoolsDiagnostics *diagnostics,
+                            const gchar          *text,
+                            gsize                 length)
+{
+  AutotoolsDiagnosticsPrivate *priv;
+  const gchar *p;
+  const gchar *end;
+  const gchar *eol;
+  guint first;
+  
+  priv = AUTOTOOLS_DIAGNOSTICS_GET_PRIVATE (diagnostics);
+  
+  first = priv->records->len;
+  p = text;
+  end = text + length;
+  
+  if (priv->carry->len > 0)
+    {
+      eol = memchr (p, '\n', end - p);
+      if (eol == NULL)
+        {
+          g_string_append_len (priv->carry, p, length);
+          return first;
+        }
+      g_string_append_len (priv->carry, p, eol - p);
+      scan_line (diagnostics, priv->carry->str, priv->carry->len);
+      priv->offset += count_chars (priv->carry->str, priv->carry->len) + 1;
+      g_string_truncate (priv->carry, 0);
+      p = eol + 1;
+    }
+
+  while (p < end && (eol = memchr (p, '\n', end - p)) != NULL)
+    {
+      scan_line (diagnostics, p, eol - p);
+      priv->offset += count_chars (p, eol - p) + 1;
+      p = eol + 1;
+    }
+  
+  if (p < end)
+    g_string_append_len (priv->carry, p, end - p);
+
+  return first;
+}
+
+guint
+autotools_diagnostics_finish (AutotoolsDiagnostics *diagnostics)
+{
+  AutotoolsDiagnosticsPrivate *priv;
+  guint first;
+  
+  priv = AUTOTOOLS_DIAGNOSTICS_GET_PRIVATE (diagnostics);
+  
+  first = priv->records->len;
+  if (priv->carry->len > 0)
+    {
+      scan_line (diagnostics, priv->carry->str, priv->carry->len);
+      priv->offset += count_chars (priv->carry->str, priv->carry->len);
+      g_string_truncate (priv->carry, 0);
+    }
+  return first;
+}
+
+static void
+scan_line (AutotoolsDiagnostics *diagnostics,
+           const gchar          *line,
+           gsize                 length)
+{
+  const gchar *end;
+  const gchar *p;
+  const gchar *colon;
+  const gchar *location_end;
+  guint32 line_number;
+  guint32 column;
+  gboolean included;
+  gint severity;
+  guint i;
+  
+  end = line + length;
+  if (length > 0 && *(end - 1) == '\r')
+    end--;
+
+  colon = memchr (line, ':', end - line);
+  if (colon == NULL)
+    return;
+  
+  if (*line == 'm' && scan_make_line (diagnostics, line, end))
+    return;
+
+  p = line;
+  included = FALSE;
+  for (i = 0; i < G_N_ELEMENTS (include_prefixes); i++)
+    {
+      const Keyword *prefix = &include_prefixes[i];
+      if ((gsize)(end - p) > prefix->length && 
+          memcmp (p, prefix->text, prefix->length) == 0)
+        {
+          p += prefix->length;
+          colon = memchr (p, ':', end - p);
+          included = TRUE;
+          break;
+        }
+    }
+  
+  if (colon == NULL || colon == p)
+    return;
+
+  for (i = 0; p + i < colon; i++)
+    {
+      if (!(char_table[(guchar) p[i]] & CHAR_PATH))
+        return;
+    }
+  
+  location_end = scan_location (colon, end, &line_number, &column);
+  if (location_end == NULL)
+    return;
+
+  if (included)
+    {
+      if (location_end < end && (*location_end == ',' || *location_end == ':'))
+        add_diagnostic (diagnostics, line, p, location_end, colon, 
+                        line_number, column, AUTOTOOLS_DIAGNOSTIC_NOTE);
+      return;
+    }
+  
+  if (location_end >= end || *location_end != ':')
+    return;
+  
+  severity = scan_keyword (location_end + 1, end);
+  if (severity < 0)
+    return;
+
+  add_diagnostic (diagnostics, line, p, location_end, colon, 
+                  line_number, column, severity);
+}
+
+/*
+ * Matches both make: *** [target] Error N and the newer form that names 
+ * the makefile and line, make[N]: *** [Makefile:450: target] Error N. 
+ * The lines that make prints when it enters and leaves a directory are 
+ * consumed here too.
+ */
+static gboolean
+scan_make_line (AutotoolsDiagnostics *diagnostics,
+                const gchar          *line,
+                const gchar          *end)
+{
+  const gchar *p;
+  const gchar *file;
+  const gchar *colon;
+  const gchar *location_end;
+  guint32 line_number;
+  guint32 column;
+  guint32 level = 0;
+
+  if (end - line < 9 || memcmp (line, "make", 4) != 0)
+    return FALSE;
+  
+  p = line + 4;
+  if (*p == '[')
+    {
+      p = scan_number (p + 1, end, &level);
+      if (p == NULL || p >= end || *p != ']')
+        return FALSE;
+      p++;
+    }
+  
+  if (end - p > 2 && memcmp (p, ": ", 2) == 0 && 
+      scan_directory_line (diagnostics, p + 2, end, level))
+    return TRUE;
+  
+  if (end - p < 5 || memcmp (p, ": ***", 5) != 0)
+    return FALSE;
+  p += 5;
+  
+  while (p < end && *p == ' ')
+    p++;
+    
+  if (p < end && *p == '[')
+    {
+      file = p + 1;
+      colon = memchr (file, ':', end - file);
+      if (colon != NULL && colon != file)
+        {
+          location_end = scan_location (colon, end, &line_number, &column);
+          if (location_end != NULL && location_end < end && *location_end == ':')
+            {
+              add_diagnostic (diagnostics, line, file, location_end, colon, 
+                              line_number, column, AUTOTOOLS_DIAGNOSTIC_ERROR);
+              return TRUE;
+            }
+        }
+    }
+  
+  add_diagnostic (diagnostics, line, line, end, NULL, 0, 0, AUTOTOOLS_DIAGNOSTIC_ERROR);
+  return TRUE;
+}
+
+/*
+ * Recursive make prints file names relative to the directory of the 
+ * sub-make, so the directories that are entered are kept on one stack 
+ * per make level. With parallel jobs the sub-makes of one level can 
+ * finish in any order, so leaving takes out the matching entry wherever 
+ * it is in the stack of its level. Make quotes the directory with '' 
+ * or, in older versions, with `'.
+ */
+static gboolean
+scan_directory_line (AutotoolsDiagnostics *diagnostics,
+                     const gchar          *p,
+                     const gchar          *end,
+                     guint32               level)
+{
+  AutotoolsDiagnosticsPrivate *priv;
+  gboolean entering;
+  GArray *stack;
+  guint32 directory_id;
+  gint i;
+  
+  priv = AUTOTOOLS_DIAGNOSTICS_GET_PRIVATE (diagnostics);
+
+  if (end - p > 19 && memcmp (p, "Entering directory ", 19) == 0)
+    {
+      entering = TRUE;
+      p += 19;
+    }
+  else if (end - p > 18 && memcmp (p, "Leaving directory ", 18) == 0)
+    {
+      entering = FALSE;
+      p += 18;
+    }
+  else
+    {
+      return FALSE;
+    }
+  
+  if (end - p < 3 || (*p != '\'' && *p != '`') || *(end - 1) != '\'')
+    return FALSE;
+  
+  /* the level is taken from the output, a bogus one must not size the stacks */
+  if (level > MAX_MAKE_LEVEL)
+    return FALSE;
+  
+  directory_id = intern_directory (diagnostics, p + 1, end - p - 2);
+  
+  while (priv->levels->len <= level)
+    g_ptr_array_add (priv->levels, g_array_new (FALSE, FALSE, sizeof (guint32)));
+  stack = g_ptr_array_index (priv->levels, level);
+  
+  if (entering)
+    {
+      g_array_append_val (stack, directory_id);
+      return TRUE;
+    }
+  
+  for (i = stack->len - 1; i >= 0; i--)
+    {
+      if (g_array_index (stack, guint32, i) == directory_id)
+        {
+          g_array_remove_index (stack, i);
+          break;
+        }
+    }
+  
+  return TRUE;
+}
+
+static guint32
+intern_directory (AutotoolsDiagnostics *diagnostics,
+                  const gchar          *path,
+                  gsize                 length)
+{
+  AutotoolsDiagnosticsPrivate *priv;
+  gchar *key;
+  gpointer value;
+  
+  priv = AUTOTOOLS_DIAGNOSTICS_GET_PRIVATE (diagnostics);
+  
+  key = g_strndup (path, length);
+  value = g_hash_table_lookup (priv->directory_ids, key);
+  if (value != NULL)
+    {
+      g_free (key);
+      return GPOINTER_TO_UINT (value) - 1;
+    }
+
+  g_ptr_array_add (priv->directories, key);
+  g_hash_table_insert (priv->directory_ids, key, GUINT_TO_POINTER (priv->directories->len));
+  return priv->directories->len - 1;
+}
+
+/*
+ * Parses the :line or :line:column that follows a file name. The colon 
+ * passed in is the one that ends the file name.
+ */
+static const gchar*
+scan_location (const gchar *colon,
+               const gchar *end,
+               guint32     *line_number,
+               guint32     *column)
+{
+  const gchar *p;
+  
+  p = scan_number (colon + 1, end, line_number);
+  if (p == NULL)
+    return NULL;
+
+  *column = 0;
+  if (p + 1 < end && *p == ':' && (char_table[(guchar) *(p + 1)] & CHAR_DIGIT))
+    p = scan_number (p + 1, end, column);
+    
+  return p;
+}
+
+static const gchar*
+scan_number (const gchar *p,
+             const gchar *end,
+             guint32     *number)
+{
+  const gchar *start;
+  guint32 value;
+  
+  start = p;
+  value = 0;
+  while (p < end && (char_table[(guchar) *p] & CHAR_DIGIT))
+    {
+      value = value * 10 + (*p - '0');
+      p++;
+    }
+  
+  if (p == start)
+    return NULL;
+  
+  *number = value;
+  return p;
+}
+
+static gint
+scan_keyword (const gchar *p,
+              const gchar *end)
+{
+  guint i;
+
+  while (p < end && *p == ' ')
+    p++;
+    
+  for (i = 0; i < G_N_ELEMENTS (keywords); i++)
+    {
+      const Keyword *keyword = &keywords[i];
+      if ((gsize)(end - p) >= keyword->length && 
+          memcmp (p, keyword->text, keyword->length) == 0)
+        return keyword->severity;
+    }
+    
+  return -1;
+}
+
+static void
+add_diagnostic (AutotoolsDiagnostics *diagnostics,
+                const gchar          *line,
+                const gchar          *start,
+                const gchar          *end,
+                const gchar          *file_end,
+                guint32               line_number,
+                guint32               column,
+                guint32               severity)
+{
+  AutotoolsDiagnosticsPrivate *priv;
+  AutotoolsDiagnostic diagnostic;
+  
+  priv = AUTOTOOLS_DIAGNOSTICS_GET_PRIVATE (diagnostics);
+
+  if (file_end != NULL)
+    diagnostic.file_id = intern_file (diagnostics, start, file_end - start);
+  else
+    diagnostic.file_id = AUTOTOOLS_DIAGNOSTIC_NO_FILE;
+
+  diagnostic.line = line_number;
+  diagnostic.column = column;
+  diagnostic.severity = severity;
+  diagnostic.offset = priv->offset + count_chars (line, start - line);
+  diagnostic.length = count_chars (start, end - start);
+  
+  g_array_append_val (priv->records, diagnostic);
+}
+
+/*
+ * A relative name is interned together with the directories that were 
+ * open when it was printed, the deepest level first and the newest 
+ * directory of each level first. Which of them it really is in can only 
+ * be told by looking at the disk, which is left to whoever resolves it.
+ */
+static guint32
+intern_file (AutotoolsDiagnostics *diagnostics,
+             const gchar          *file,
+             gsize                 length)
+{
+  AutotoolsDiagnosticsPrivate *priv;
+  GArray *directories;
+  GString *key;
+  File *entry;
+  gpointer value;
+  gint level;
+  gint i;
+  
+  priv = AUTOTOOLS_DIAGNOSTICS_GET_PRIVATE (diagnostics);
+  
+  directories = g_array_new (FALSE, FALSE, sizeof (guint32));
+  key = g_string_new_len (file, length);
+  
+  if (!g_path_is_absolute (key->str))
+    {
+      for (level = priv->levels->len - 1; level >= 0; level--)
+        {
+          GArray *stack = g_ptr_array_index (priv->levels, level);
+          for (i = stack->len - 1; i >= 0; i--)
+            {
+              guint32 directory_id = g_array_index (stack, guint32, i);
+              g_array_append_val (directories, directory_id);
+              g_string_append_printf (key, "\n%u", directory_id);
+            }
+        }
+    }
+  
+  value = g_hash_table_lookup (priv->file_ids, key->str);
+  if (value != NULL)
+    {
+      g_string_free (key, TRUE);
+      g_array_free (directories, TRUE);
+      return GPOINTER_TO_UINT (value) - 1;
+    }
+
+  entry = g_malloc (sizeof (File));
+  entry->name = g_strndup (file, length);
+  entry->n_directories = directories->len;
+  entry->directories = (guint32 *) g_array_free (directories, FALSE);
+  
+  g_ptr_array_add (priv->files, entry);
+  g_hash_table_insert (priv->file_ids, g_string_free (key, FALSE), 
+                       GUINT_TO_POINTER (priv->files->len));
+  return priv->files->len - 1;
+}
+
+/*
+ * Joins the file name to the directory and drops the . and .. segments, 
+ * so that names reached through different directories, such as 
+ * ../../src/foo.c, come out as the same path.
+ */
+static gchar*
+join_path (const gchar *directory,
+           const gchar *file)
+{
+  GPtrArray *parts;
+  GString *path;
+  gchar **segments;
+  gchar **segment;
+  gchar *joined;
+  guint i;
+  
+  if (!g_path_is_absolute (directory))
+    return g_build_filename (directory, file, NULL);
+  
+  joined = g_build_filename (directory, file, NULL);
+  segments = g_strsplit (joined, G_DIR_SEPARATOR_S, -1);
+  g_free (joined);
+  
+  parts = g_ptr_array_new ();
+  for (segment = segments; *segment != NULL; segment++)
+    {
+      if (**segment == '\0' || g_strcmp0 (*segment, ".") == 0)
+        continue;
+      if (g_strcmp0 (*segment, "..") == 0)
+        {
+          if (parts->len > 0)
+            g_ptr_array_remove_index (parts, parts->len - 1);
+          continue;
+        }
+      g_ptr_array_add (parts, *segment);
+    }
+  
+  path = g_string_new (NULL);
+  for (i = 0; i < parts->len; i++)
+    {
+      g_string_append_c (path, G_DIR_SEPARATOR);
+      g_string_append (path, g_ptr_array_index (parts, i));
+    }
+  if (path->len == 0)
+    g_string_append_c (path, G_DIR_SEPARATOR);
+  
+  g_ptr_array_free (parts, TRUE);
+  g_strfreev (segments);
+  
+  return g_string_free (path, FALSE);
+}
+
+static void
+free_file (File *file)
+{
+  g_free (file->name);
+  g_free (file->directories);
+  g_free (file);
+}
+
+static gint
+count_chars (const gchar *text,
+             gsize        length)
+{
+  gint chars;
+  gsize i;
+  
+  chars = 0;
+  for (i = 0; i < length; i++)
+    chars += ((guchar) text[i] & 0xC0) != 0x80;
+
+  return chars;
+}
+
+void
+autotools_diagnostics_remove_before (AutotoolsDiagnostics *diagnostics,
+                                     gint64                offset)
+{
+  AutotoolsDiagnosticsPrivate *priv;
+  guint i;
+  
+  priv = AUTOTOOLS_DIAGNOSTICS_GET_PRIVATE (diagnostics);
+  
+  for (i = 0; i < priv->records->len; i++)
+    {
+      AutotoolsDiagnostic *diagnostic;
+      diagnostic = &g_array_index (priv->records, AutotoolsDiagnostic, i);
+      if (diagnostic->offset + diagnostic->length > offset)
+        break;
+    }
+    
+  if (i > 0)
+    g_array_remove_range (priv->records, 0, i);
+}
+
+guint
+autotools_diagnostics_get_length (AutotoolsDiagnostics *diagnostics)
+{
+  return AUTOTOOLS_DIAGNOSTICS_GET_PRIVATE (diagnostics)->records->len;
+}
+
+AutotoolsDiagnostic*
+autotools_diagnostics_get (AutotoolsDiagnostics *diagnostics,
+                           guint                 index)
+{
+  AutotoolsDiagnosticsPrivate *priv;
+  priv = AUTOTOOLS_DIAGNOSTICS_GET_PRIVATE (diagnostics);
+  return &g_array_index (priv->records, AutotoolsDiagnostic, index);
+}
+
+AutotoolsDiagnostic*
+autotools_diagnostics_find (AutotoolsDiagnostics *diagnostics,
+                            gint64                offset)
+{
+  AutotoolsDiagnosticsPrivate *priv;
+  guint low;
+  guint high;
+  
+  priv = AUTOTOOLS_DIAGNOSTICS_GET_PRIVATE (diagnostics);
+  
+  low = 0;
+  high = priv->records->len;
+  
+  while (low < high)
+    {
+      AutotoolsDiagnostic *diagnostic;
+      guint mid;
+      mid = (low + high) / 2;
+      diagnostic = &g_array_index (priv->records, AutotoolsDiagnostic, mid);
+      if (offset < diagnostic->offset)
+        high = mid;
+      else if (offset >= diagnostic->offset + diagnostic->length)
+        low = mid + 1;
+      else
+        return diagnostic;
+    }
+    
+  return NULL;
+}
+
+const gchar*
+autotools_diagnostics_get_file (AutotoolsDiagnostics *diagnostics,
+                                guint32               file_id)
+{
+  AutotoolsDiagnosticsPrivate *priv;
+  priv = AUTOTOOLS_DIAGNOSTICS_GET_PRIVATE (diagnostics);
+  if (file_id >= priv->files->len)
+    return NULL;
+  return ((File *) g_ptr_array_index (priv->files, file_id))->name;
+}
+
+/*
+ * Returns the file joined to the directory at index in its list of 
+ * candidates, or NULL once the list is exhausted.
+ */
+gchar*
+autotools_diagnostics_get_path (AutotoolsDiagnostics *diagnostics,
+                                guint32               file_id,
+                                guint                 index)
+{
+  AutotoolsDiagnosticsPrivate *priv;
+  File *file;
+  
+  priv = AUTOTOOLS_DIAGNOSTICS_GET_PRIVATE (diagnostics);
+  if (file_id >= priv->files->len)
+    return NULL;
+  
+  file = g_ptr_array_index (priv->files, file_id);
+  if (index >= file->n_directories)
+    return NULL;
+  
+  return join_path (g_ptr_array_index (priv->directories, file->directories[index]), file->name);
+}
+
+guint
+autotools_diagnostics_get_file_count (AutotoolsDiagnostics *diagnostics)
+{
+  return AUTOTOOLS_DIAGNOSTICS_GET_PRIVATE (diagnostics)->files->len;
+}
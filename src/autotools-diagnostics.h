@@ -0,0 +1,89 @@
+/*
+ * Copyright (C) 2010 - Jeff Johnston
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+ */
+
+#ifndef __AUTOTOOLS_DIAGNOSTICS_H__
+#define	__AUTOTOOLS_DIAGNOSTICS_H__
+
+#include <gtk/gtk.h>
+
+G_BEGIN_DECLS
+
+#define AUTOTOOLS_DIAGNOSTICS_TYPE            (autotools_diagnostics_get_type ())
+#define AUTOTOOLS_DIAGNOSTICS(obj)            (G_TYPE_CHECK_INSTANCE_CAST ((obj), AUTOTOOLS_DIAGNOSTICS_TYPE, AutotoolsDiagnostics))
+#define AUTOTOOLS_DIAGNOSTICS_CLASS(klass)    (G_TYPE_CHECK_CLASS_CAST ((klass), AUTOTOOLS_DIAGNOSTICS_TYPE, AutotoolsDiagnosticsClass))
+#define IS_AUTOTOOLS_DIAGNOSTICS(obj)         (G_TYPE_CHECK_INSTANCE_TYPE ((obj), AUTOTOOLS_DIAGNOSTICS_TYPE))
+#define IS_AUTOTOOLS_DIAGNOSTICS_CLASS(klass) (G_TYPE_CHECK_CLASS_TYPE ((klass), AUTOTOOLS_DIAGNOSTICS_TYPE))
+
+#define AUTOTOOLS_DIAGNOSTIC_NO_FILE G_MAXUINT32
+
+typedef enum
+{
+  AUTOTOOLS_DIAGNOSTIC_NOTE,
+  AUTOTOOLS_DIAGNOSTIC_WARNING,
+  AUTOTOOLS_DIAGNOSTIC_ERROR
+} AutotoolsDiagnosticSeverity;
+
+typedef struct
+{
+  guint32 file_id;
+  guint32 line;
+  guint32 column;
+  guint32 severity;
+  gint64  offset;
+  gint    length;
+} AutotoolsDiagnostic;
+
+typedef struct _AutotoolsDiagnostics AutotoolsDiagnostics;
+typedef struct _AutotoolsDiagnosticsClass AutotoolsDiagnosticsClass;
+
+struct _AutotoolsDiagnostics
+{
+  GObject parent_instance;
+};
+
+struct _AutotoolsDiagnosticsClass
+{
+  GObjectClass parent_class;
+};
+
+GType autotools_diagnostics_get_type (void) G_GNUC_CONST;
+
+AutotoolsDiagnostics*  autotools_diagnostics_new            (void);
+
+void                   autotools_diagnostics_clear          (AutotoolsDiagnostics *diagnostics);
+guint                  autotools_diagnostics_scan           (AutotoolsDiagnostics *diagnostics,
+                                                             const gchar          *text,
+                                                             gsize                 length);
+guint                  autotools_diagnostics_finish         (AutotoolsDiagnostics *diagnostics);
+void                   autotools_diagnostics_remove_before  (AutotoolsDiagnostics *diagnostics,
+                                                             gint64                offset);
+guint                  autotools_diagnostics_get_length     (AutotoolsDiagnostics *diagnostics);
+AutotoolsDiagnostic*   autotools_diagnostics_get            (AutotoolsDiagnostics *diagnostics,
+                                                             guint                 index);
+AutotoolsDiagnostic*   autotools_diagnostics_find           (AutotoolsDiagnostics *diagnostics,
+                                                             gint64                offset);
+const gchar*           autotools_diagnostics_get_file       (AutotoolsDiagnostics *diagnostics,
+                                                             guint32               file_id);
+gchar*                 autotools_diagnostics_get_path       (AutotoolsDiagnostics *diagnostics,
+                                                             guint32               file_id,
+                                                             guint                 index);
+guint                  autotools_diagnostics_get_file_count (AutotoolsDiagnostics *diagnostics);
+
+G_END_DECLS
+
+#endif /* __AUTOTOOLS_DIAGNOSTICS_H__ */
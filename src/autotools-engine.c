@@ -16,24 +16,140 @@
  * Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
  */
 
+#include <stdlib.h>
+#include <string.h>
+#include <sys/wait.h>
+#include <glib/gstdio.h>
 #include <codeslayer/codeslayer-utils.h>
 #include "autotools-engine.h"
 #include "autotools-project-properties.h"
 #include "autotools-config.h"
 #include "autotools-notebook.h"
 #include "autotools-output.h"
+#include "autotools-process.h"
+#include "autotools-launcher.h"
+#include "autotools-timing.h"
+
+typedef struct _Batch Batch;
+
+typedef void (*ExecuteFunc) (AutotoolsEngine *engine,
+                             AutotoolsOutput *output,
+                             Batch           *batch);
 
 typedef struct
 {
   AutotoolsOutput *output;
-  gchar           *text;
-} OutputContext;
+  gchar           *name;
+  gint             blockers;
+  gint             unresolved;
+  GList           *dependents;
+  gboolean         finished;
+} BatchNode;
+
+struct _Batch
+{
+  AutotoolsEngine *engine;
+  ExecuteFunc      execute;
+  GTimer          *timer;
+  GHashTable      *nodes;
+  gint             total;
+  gint             remaining;
+};
+
+typedef struct
+{
+  gchar  *working_directory;
+  gchar **argv;
+  gchar  *text;
+  gchar  *stamp_path;
+  gchar  *stamp;
+  gchar  *cache_path;
+} Step;
+
+typedef struct
+{
+  GList  *steps;
+  gchar **envp;
+  gchar  *finished_text;
+  GList  *tasks;
+  gboolean interactive;
+} Command;
+
+typedef struct
+{
+  AutotoolsEngine  *engine;
+  AutotoolsOutput  *output;
+  AutotoolsProcess *process;
+  Command          *command;
+  gboolean          stopped;
+  gboolean          succeeded;
+  gint              slots;
+  GList            *batches;
+  gboolean          has_launcher_stats;
+  AutotoolsLauncherStats launcher_stats;
+  AutotoolsProcessUsage  usage;
+  guint             errors;
+  guint             warnings;
+  Command          *pending_command;
+} Build;
+
+typedef struct
+{
+  AutotoolsConfig   *config;
+  GCancellable      *cancellable;
+  gulong             cancelled_id;
+} Run;
+
+typedef struct
+{
+  AutotoolsOutput        *output;
+  gchar                  *launcher;
+  AutotoolsLauncherStats  stats;
+} LauncherRead;
+
+typedef struct
+{
+  AutotoolsEngine   *engine;
+  CodeSlayerProject *project;
+  guint              source_id;
+} SaveTimer;
+
+typedef struct
+{
+  AutotoolsEngine   *engine;
+  CodeSlayerProject *project;
+  gchar             *file_path;
+  AutotoolsConfig   *config;
+  GFileMonitor      *monitor;
+} ConfigEntry;
 
 #define MAIN "main"
 #define CONFIGURE_FILE "configure_file"
 #define CONFIGURE_PARAMETERS "configure_parameters"
 #define BUILD_FOLDER "build_folder"
+#define SCROLLBACK_LINES "scrollback_lines"
+#define SCROLLBACK_CHARS "scrollback_chars"
+#define DUPLICATE_BUILD "duplicate_build"
+#define DUPLICATE_BUILD_RESTART "restart"
+#define JOBS "jobs"
+#define LOAD_AVERAGE "load_average"
+#define DEPENDS_ON "depends_on"
+#define CONFIGURE_CACHE "configure_cache"
+#define COMPILER_LAUNCHER "compiler_launcher"
+#define BUILD_ON_SAVE "build_on_save"
+#define BUILD_ON_SAVE_DELAY "build_on_save_delay"
+#define PROFILE_TARGETS "profile_targets"
+#define ENVIRONMENT "environment"
+#define ACTIVE_CONFIGURATIONS "active_configurations"
+#define CONFIGURATION "configuration "
+#define DEFAULT_CONFIGURATION "default"
+#define SLOWEST_TARGETS 10
+#define CONFIGURE_CACHE_PROJECT "project"
+#define CONFIGURE_CACHE_SHARED "shared"
 #define AUTOTOOLS_CONF "autotools.conf"
+#define CONFIGURE_STAMP ".codeslayer-configure-stamp"
+#define CONFIGURE_CACHE_FILE "config.cache"
+#define TOOLCHAIN_SUFFIX ".toolchain"
 
 static void autotools_engine_class_init              (AutotoolsEngineClass *klass);
 static void autotools_engine_init                    (AutotoolsEngine      *engine);
@@ -53,26 +169,206 @@ static void project_make_clean_action                (AutotoolsEngine      *engi
 
 static void project_configure_action                 (AutotoolsEngine      *engine, 
                                                       GList                *selections);
+static void run_selections                           (AutotoolsEngine      *engine, 
+                                                      GList                *selections,
+                                                      ExecuteFunc           execute);
 
+static void run_outputs                              (AutotoolsEngine      *engine, 
+                                                      GList                *outputs,
+                                                      ExecuteFunc           execute);
 static void project_autoreconf_action                (AutotoolsEngine      *engine, 
                                                       GList                *selections);
 
-static void execute_make                             (AutotoolsOutput      *output);
-static void execute_make_clean                       (AutotoolsOutput      *output);
-static void execute_make_install                     (AutotoolsOutput      *output);
-static void execute_configure                        (AutotoolsOutput      *output);
-static void execute_autoreconf                       (AutotoolsOutput      *output);
+static void project_full_build_action                (AutotoolsEngine      *engine, 
+                                                      GList                *selections);
+
+static void project_clear_configure_cache_action     (AutotoolsEngine      *engine, 
+                                                      GList                *selections);
 
-static void run_command                              (AutotoolsOutput      *output,
-                                                      gchar                *command);
+static void make_directory_action                    (AutotoolsEngine      *engine);
+static void compile_file_action                      (AutotoolsEngine      *engine);
+static gchar* get_active_document_relative_path      (AutotoolsEngine      *engine,
+                                                      AutotoolsOutput      *output);
+static gchar* get_object_target                      (const gchar          *build_folder,
+                                                      const gchar          *relative_path,
+                                                      gchar               **makefile_folder);
+static gchar* get_relative_prefix                    (const gchar          *relative_path,
+                                                      const gchar          *relative_folder);
+static gchar* find_object_target                     (const gchar          *folder,
+                                                      const gchar          *prefix,
+                                                      const gchar          *stem);
+
+static void stop_action                              (AutotoolsEngine      *engine);
+static void output_stop_action                       (AutotoolsEngine      *engine,
+                                                      AutotoolsOutput      *output);
+static void output_export_trace_action               (AutotoolsEngine      *engine,
+                                                      AutotoolsOutput      *output);
+static void output_destroyed_action                  (AutotoolsOutput      *output,
+                                                      AutotoolsEngine      *engine);
+
+static void document_saved_action                    (AutotoolsEngine      *engine,
+                                                      CodeSlayerDocument   *document);
+static gboolean build_on_save_action                 (SaveTimer            *save_timer);
+static void destroy_save_timer                       (SaveTimer            *save_timer);
+
+static void execute_make                             (AutotoolsEngine      *engine,
+                                                      AutotoolsOutput      *output,
+                                                      Batch                *batch);
+static void execute_make_clean                       (AutotoolsEngine      *engine,
+                                                      AutotoolsOutput      *output,
+                                                      Batch                *batch);
+static void execute_make_install                     (AutotoolsEngine      *engine,
+                                                      AutotoolsOutput      *output,
+                                                      Batch                *batch);
+static void execute_configure                        (AutotoolsEngine      *engine,
+                                                      AutotoolsOutput      *output,
+                                                      Batch                *batch);
+static void execute_autoreconf                       (AutotoolsEngine      *engine,
+                                                      AutotoolsOutput      *output,
+                                                      Batch                *batch);
+static void execute_full_build                       (AutotoolsEngine      *engine,
+                                                      AutotoolsOutput      *output,
+                                                      Batch                *batch);
+
+static gchar* get_configure_checksum                 (AutotoolsConfig      *config);
+static gchar* get_configure_cache_path               (AutotoolsEngine      *engine,
+                                                      AutotoolsConfig      *config,
+                                                      gchar               **envp);
+static gchar* get_cache_file_option                  (AutotoolsEngine      *engine,
+                                                      AutotoolsConfig      *config,
+                                                      gchar               **envp);
+static void check_configure_cache                    (Build                *build,
+                                                      Step                 *step);
+static gchar* get_toolchain_settings                 (AutotoolsConfig      *config,
+                                                      gchar               **envp);
+static gchar* get_toolchain_fingerprint              (AutotoolsConfig      *config,
+                                                      gchar               **envp);
+static gchar* find_program                           (const gchar          *program,
+                                                      gchar               **envp);
+static gboolean get_modified_time                    (const gchar          *file_path,
+                                                      time_t               *mtime);
+static gboolean autoreconf_needed                    (const gchar          *source_folder);
+static gboolean is_newer                             (const gchar          *file_path,
+                                                      time_t                mtime);
+static gboolean has_newer_macros                     (const gchar          *folder_path,
+                                                      time_t                mtime);
+static void add_macro_arguments                      (const gchar          *contents,
+                                                      const gchar          *macro,
+                                                      GPtrArray            *arguments);
+static gboolean configure_needed                     (const gchar          *configure_path,
+                                                      const gchar          *build_folder,
+                                                      const gchar          *stamp_path,
+                                                      const gchar          *checksum);
+
+static gint get_jobs                                 (AutotoolsConfig      *config);
+static gchar** get_make_argv                         (AutotoolsConfig      *config,
+                                                      const gchar          *directory,
+                                                      const gchar          *target);
+static gchar** get_configure_argv                    (AutotoolsEngine      *engine,
+                                                      AutotoolsConfig      *config,
+                                                      const gchar          *configure_path,
+                                                      gchar               **envp,
+                                                      GError              **error);
+static void report_configure_error                   (AutotoolsOutput      *output,
+                                                      Batch                *batch,
+                                                      GError               *error);
+static gchar** get_environment                       (AutotoolsConfig      *config);
+static gchar* expand_variables                       (const gchar          *value,
+                                                      gchar               **envp);
+static Command* new_command                          (AutotoolsConfig      *config,
+                                                      const gchar          *finished_text);
+static Step* add_step                                (Command              *command,
+                                                      const gchar          *working_directory,
+                                                      gchar               **argv,
+                                                      const gchar          *text);
+static gchar* get_command_text                       (Command              *command);
+static void destroy_command                          (Command              *command);
+static void destroy_step                             (Step                 *step);
+static void run_command                              (AutotoolsEngine      *engine,
+                                                      AutotoolsOutput      *output,
+                                                      Batch                *batch,
+                                                      Command              *command);
+static void schedule_builds                          (AutotoolsEngine      *engine);
+static void process_output_action                    (AutotoolsOutput      *output,
+                                                      const gchar          *text);
+static void process_finished_action                  (AutotoolsProcess     *process,
+                                                      gint                  status,
+                                                      Build                *build);
+static void start_build                              (Build                *build);
+static gboolean start_step                           (Build                *build);
+static gboolean next_step                            (Build                *build);
+static void finish_build                             (Build                *build,
+                                                      gint                  status);
+static void launcher_stats_started_action            (GObject              *source,
+                                                      GAsyncResult         *result,
+                                                      Build                *build);
+static void launcher_stats_finished_action           (GObject              *source,
+                                                      GAsyncResult         *result,
+                                                      LauncherRead         *read);
+static void cancel_launcher_read                     (GCancellable         *cancellable);
+static void add_usage                                (AutotoolsProcessUsage       *total,
+                                                      const AutotoolsProcessUsage *usage);
+static const gchar* get_compiler_launcher            (Build                *build);
+static gchar* get_timing_log_path                    (Build                *build);
+static void remove_timing_log                        (Build                *build);
+static gchar* get_usage_text                         (const AutotoolsProcessUsage *usage);
+static void remove_build                             (Build                *build);
+static void release_process                          (Build                *build);
+static Batch* new_batch                              (AutotoolsEngine      *engine,
+                                                      ExecuteFunc           execute,
+                                                      GList                *outputs);
+static void add_batch_dependency                     (BatchNode            *dependency,
+                                                      BatchNode            *node);
+static void add_source_dependencies                  (Batch                *batch,
+                                                      GList                *outputs);
+static void start_batch                              (Batch                *batch,
+                                                      GList                *outputs);
+static void finish_batch                             (Batch                *batch,
+                                                      AutotoolsOutput      *output,
+                                                      gboolean              succeeded);
+static void cancel_batch_node                        (Batch                *batch,
+                                                      BatchNode            *node,
+                                                      const gchar          *text);
+static void release_batch                            (Batch                *batch,
+                                                      AutotoolsOutput      *output);
+static void destroy_batch                            (Batch                *batch);
+static void destroy_build                            (Build                *build);
+static AutotoolsBuildResult* new_build_result        (Build                *build,
+                                                      gint                  status);
+static void return_tasks                             (Command              *command,
+                                                      AutotoolsBuildResult *result);
+static void output_diagnostics_action                (AutotoolsOutput      *output,
+                                                      guint                 first,
+                                                      guint                 last,
+                                                      AutotoolsEngine      *engine);
+static void run_cancelled_action                     (GCancellable         *cancellable,
+                                                      GTask                *task);
+static gboolean run_cancelled_idle                   (GTask                *task);
+static void destroy_run                              (Run                  *run);
+static void free_build_diagnostic                    (AutotoolsBuildDiagnostic *diagnostic);
 
 static AutotoolsConfig* get_config_by_project        (AutotoolsEngine      *engine, 
                                                       CodeSlayerProject    *project);
-static void execute_configure                        (AutotoolsOutput      *output);
-static AutotoolsOutput* get_output_by_active_document  (AutotoolsEngine      *engine);
-
-static AutotoolsOutput* get_output_by_project        (AutotoolsEngine      *engine, 
+static void load_config                              (ConfigEntry          *entry);
+static void read_config                              (AutotoolsConfig      *config,
+                                                      GKeyFile             *key_file,
+                                                      const gchar          *group);
+static const gchar* get_group                        (GKeyFile             *key_file,
+                                                      const gchar          *group,
+                                                      const gchar          *key);
+static void config_folder_changed_action             (GFileMonitor         *monitor,
+                                                      GFile                *file,
+                                                      GFile                *other_file,
+                                                      GFileMonitorEvent     event_type,
+                                                      ConfigEntry          *entry);
+static void destroy_config_entry                     (ConfigEntry          *entry);
+static GList* get_outputs_by_active_document         (AutotoolsEngine      *engine);
+static GList* get_outputs_by_project                 (AutotoolsEngine      *engine, 
                                                       CodeSlayerProject    *project);
+static AutotoolsOutput* get_output_by_config         (AutotoolsEngine      *engine, 
+                                                      AutotoolsConfig      *config);
+static gchar* get_config_label                       (AutotoolsConfig      *config);
+static gchar* get_real_path                          (const gchar          *path);
 
 static void project_properties_opened_action         (AutotoolsEngine      *engine,
                                                       CodeSlayerProject    *project);
@@ -82,12 +378,7 @@ static void project_properties_saved_action          (AutotoolsEngine      *engi
 static void save_config_action                       (AutotoolsEngine      *engine,
                                                       AutotoolsConfig      *config);
                                                                   
-static CodeSlayerProject* get_selections_project     (GList                *selections);
 
-static gboolean clear_text                           (AutotoolsOutput      *output);
-static gboolean append_text                          (OutputContext        *context);
-static void     destroy_text                         (OutputContext        *context);
-static gboolean create_links                         (AutotoolsOutput      *output);
                                                    
 #define AUTOTOOLS_ENGINE_GET_PRIVATE(obj) \
   (G_TYPE_INSTANCE_GET_PRIVATE ((obj), AUTOTOOLS_ENGINE_TYPE, AutotoolsEnginePrivate))
@@ -101,17 +392,72 @@ struct _AutotoolsEnginePrivate
   GtkWidget  *project_properties;
   GtkWidget  *projects_menu;
   GtkWidget  *notebook;
-  GList      *configs;
+  GHashTable *configs;
+  GHashTable *builds;
+  GQueue     *waiting;
+  GList      *batches;
+  gint        running_slots;
+  gint        max_slots;
   gulong      properties_opened_id;
   gulong      properties_saved_id;
+  gulong      document_saved_id;
+  GHashTable *save_timers;
+  GHashTable *launcher_reads;
+};
+
+enum
+{
+  BUILD_STARTED,
+  DIAGNOSTICS_BATCH,
+  BUILD_FINISHED,
+  LAST_SIGNAL
 };
 
+static guint autotools_engine_signals[LAST_SIGNAL] = { 0 };
+
 G_DEFINE_TYPE (AutotoolsEngine, autotools_engine, G_TYPE_OBJECT)
 
+G_DEFINE_BOXED_TYPE (AutotoolsBuildResult, autotools_build_result, 
+                     autotools_build_result_copy, autotools_build_result_free)
+
+/*
+ * The signals let other plugins follow every build, including the ones 
+ * started from the menus. All of them pass the project first. 
+ * build-started also passes the command line. diagnostics-batch passes 
+ * a GPtrArray of AutotoolsBuildDiagnostic for the lines parsed since the 
+ * last batch. build-finished passes an AutotoolsBuildResult. The payloads 
+ * belong to the engine and only live for the emission.
+ */
 static void
 autotools_engine_class_init (AutotoolsEngineClass *klass)
 {
   GObjectClass *gobject_class = G_OBJECT_CLASS (klass);
+
+  autotools_engine_signals[BUILD_STARTED] =
+    g_signal_new ("build-started", 
+                  G_TYPE_FROM_CLASS (klass),
+                  G_SIGNAL_RUN_LAST | G_SIGNAL_NO_RECURSE | G_SIGNAL_NO_HOOKS,
+                  G_STRUCT_OFFSET (AutotoolsEngineClass, build_started),
+                  NULL, NULL, 
+                  NULL, G_TYPE_NONE, 2, CODESLAYER_PROJECT_TYPE, G_TYPE_STRING);
+
+  autotools_engine_signals[DIAGNOSTICS_BATCH] =
+    g_signal_new ("diagnostics-batch", 
+                  G_TYPE_FROM_CLASS (klass),
+                  G_SIGNAL_RUN_LAST | G_SIGNAL_NO_RECURSE | G_SIGNAL_NO_HOOKS,
+                  G_STRUCT_OFFSET (AutotoolsEngineClass, diagnostics_batch),
+                  NULL, NULL, 
+                  NULL, G_TYPE_NONE, 2, CODESLAYER_PROJECT_TYPE, 
+                  G_TYPE_PTR_ARRAY | G_SIGNAL_TYPE_STATIC_SCOPE);
+
+  autotools_engine_signals[BUILD_FINISHED] =
+    g_signal_new ("build-finished", 
+                  G_TYPE_FROM_CLASS (klass),
+                  G_SIGNAL_RUN_LAST | G_SIGNAL_NO_RECURSE | G_SIGNAL_NO_HOOKS,
+                  G_STRUCT_OFFSET (AutotoolsEngineClass, build_finished),
+                  NULL, NULL, 
+                  NULL, G_TYPE_NONE, 2, CODESLAYER_PROJECT_TYPE, 
+                  AUTOTOOLS_BUILD_RESULT_TYPE | G_SIGNAL_TYPE_STATIC_SCOPE);
   gobject_class->finalize = (GObjectFinalizeFunc) autotools_engine_finalize;
   g_type_class_add_private (klass, sizeof (AutotoolsEnginePrivate));
 }
@@ -121,7 +467,18 @@ autotools_engine_init (AutotoolsEngine *engine)
 {
   AutotoolsEnginePrivate *priv;
   priv = AUTOTOOLS_ENGINE_GET_PRIVATE (engine);
-  priv->configs = NULL;
+  priv->configs = g_hash_table_new_full (g_direct_hash, g_direct_equal, NULL, 
+                                         (GDestroyNotify) destroy_config_entry);
+  priv->builds = g_hash_table_new_full (g_direct_hash, g_direct_equal, NULL, 
+                                        (GDestroyNotify) destroy_build);
+  priv->waiting = g_queue_new ();
+  priv->batches = NULL;
+  priv->save_timers = g_hash_table_new_full (g_direct_hash, g_direct_equal, NULL, 
+                                             (GDestroyNotify) destroy_save_timer);
+  priv->launcher_reads = g_hash_table_new_full (g_direct_hash, g_direct_equal, NULL, 
+                                                (GDestroyNotify) cancel_launcher_read);
+  priv->running_slots = 0;
+  priv->max_slots = g_get_num_processors ();
 }
 
 static void
@@ -129,15 +486,17 @@ autotools_engine_finalize (AutotoolsEngine *engine)
 {
   AutotoolsEnginePrivate *priv;
   priv = AUTOTOOLS_ENGINE_GET_PRIVATE (engine);
-  if (priv->configs != NULL)
-    {
-      g_list_foreach (priv->configs, (GFunc) g_object_unref, NULL);
-      g_list_free (priv->configs);
-      priv->configs = NULL;    
-    }
+  g_queue_free (priv->waiting);
+  g_list_foreach (priv->batches, (GFunc) destroy_batch, NULL);
+  g_list_free (priv->batches);
+  g_hash_table_destroy (priv->builds);
+  g_hash_table_destroy (priv->configs);
   
   g_signal_handler_disconnect (priv->codeslayer, priv->properties_opened_id);
   g_signal_handler_disconnect (priv->codeslayer, priv->properties_saved_id);
+  g_signal_handler_disconnect (priv->codeslayer, priv->document_saved_id);
+  g_hash_table_destroy (priv->save_timers);
+  g_hash_table_destroy (priv->launcher_reads);
 
   G_OBJECT_CLASS (autotools_engine_parent_class)->finalize (G_OBJECT(engine));
 }
@@ -185,62 +544,417 @@ autotools_engine_new (CodeSlayer *codeslayer,
   g_signal_connect_swapped (G_OBJECT (projects_menu), "autoreconf",
                             G_CALLBACK (project_autoreconf_action), engine);
 
+  g_signal_connect_swapped (G_OBJECT (projects_menu), "full-build",
+                            G_CALLBACK (project_full_build_action), engine);
+
+  g_signal_connect_swapped (G_OBJECT (projects_menu), "clear-configure-cache",
+                            G_CALLBACK (project_clear_configure_cache_action), engine);
+
+  g_signal_connect_swapped (G_OBJECT (menu), "make-directory",
+                            G_CALLBACK (make_directory_action), engine);
+
+  g_signal_connect_swapped (G_OBJECT (menu), "compile-file",
+                            G_CALLBACK (compile_file_action), engine);
+
+  g_signal_connect_swapped (G_OBJECT (menu), "stop",
+                            G_CALLBACK (stop_action), engine);
+
+  g_signal_connect_swapped (G_OBJECT (notebook), "stop",
+                            G_CALLBACK (output_stop_action), engine);
+
+  g_signal_connect_swapped (G_OBJECT (notebook), "export-trace",
+                            G_CALLBACK (output_export_trace_action), engine);
+
   priv->properties_opened_id =  g_signal_connect_swapped (G_OBJECT (codeslayer), "project-properties-opened",
                                                           G_CALLBACK (project_properties_opened_action), engine);
 
   priv->properties_saved_id = g_signal_connect_swapped (G_OBJECT (codeslayer), "project-properties-saved",
                                                         G_CALLBACK (project_properties_saved_action), engine);
 
+  priv->document_saved_id = g_signal_connect_swapped (G_OBJECT (codeslayer), "document-saved",
+                                                      G_CALLBACK (document_saved_action), engine);
+
   g_signal_connect_swapped (G_OBJECT (project_properties), "save-config",
                             G_CALLBACK (save_config_action), engine);
 
   return engine;
 }
 
+void
+autotools_engine_load_configs (AutotoolsEngine *engine)
+{
+  AutotoolsEnginePrivate *priv;
+  GHashTableIter iter;
+  ConfigEntry *entry;
+  
+  priv = AUTOTOOLS_ENGINE_GET_PRIVATE (engine);
+
+  g_hash_table_iter_init (&iter, priv->configs);
+  while (g_hash_table_iter_next (&iter, NULL, (gpointer) &entry))
+    load_config (entry);
+}
+
+/*
+ * Runs make with the given target, or the default one when target is 
+ * NULL, in the build folder of the first active configuration of the 
+ * project. The build goes through the same queue as the ones started 
+ * from the menus, so a request for a configuration that is already 
+ * building joins that build. Cancelling only returns this request, the 
+ * build itself is stopped when nobody else is waiting for it.
+ */
+void
+autotools_engine_run_async (AutotoolsEngine     *engine,
+                            CodeSlayerProject   *project,
+                            const gchar         *target,
+                            GCancellable        *cancellable,
+                            GAsyncReadyCallback  callback,
+                            gpointer             user_data)
+{
+  AutotoolsConfig *config;
+  AutotoolsOutput *output;
+  GList *outputs;
+  Command *command;
+  GTask *task;
+  Run *run;
+  
+  task = g_task_new (engine, cancellable, callback, user_data);
+  g_task_set_source_tag (task, autotools_engine_run_async);
+  
+  if (g_task_return_error_if_cancelled (task))
+    {
+      g_object_unref (task);
+      return;
+    }
+  
+  config = get_config_by_project (engine, project);
+  if (config == NULL)
+    {
+      g_task_return_new_error (task, G_IO_ERROR, G_IO_ERROR_NOT_FOUND, 
+                               "There is no config for project %s.", 
+                               codeslayer_project_get_name (project));
+      g_object_unref (task);
+      return;
+    }
+  
+  outputs = get_outputs_by_project (engine, project);
+  output = outputs->data;
+  config = autotools_output_get_config (output);
+  g_list_free (outputs);
+  
+  run = g_malloc (sizeof (Run));
+  run->config = g_object_ref (config);
+  run->cancellable = cancellable;
+  run->cancelled_id = 0;
+  if (cancellable != NULL)
+    {
+      g_object_ref (cancellable);
+      run->cancelled_id = g_cancellable_connect (cancellable, G_CALLBACK (run_cancelled_action), 
+                                                 task, NULL);
+    }
+  g_task_set_task_data (task, run, (GDestroyNotify) destroy_run);
+  
+  command = new_command (config, NULL);
+  command->interactive = FALSE;
+  command->tasks = g_list_append (NULL, task);
+  add_step (command, autotools_config_get_build_folder (config), 
+            get_make_argv (config, NULL, target), NULL);
+  run_command (engine, output, NULL, command);
+}
+
+AutotoolsBuildResult*
+autotools_engine_run_finish (AutotoolsEngine  *engine,
+                             GAsyncResult     *result,
+                             GError          **error)
+{
+  g_return_val_if_fail (g_task_is_valid (result, engine), NULL);
+  return g_task_propagate_pointer (G_TASK (result), error);
+}
+
+AutotoolsBuildResult*
+autotools_build_result_copy (AutotoolsBuildResult *result)
+{
+  return g_memdup (result, sizeof (AutotoolsBuildResult));
+}
+
+void
+autotools_build_result_free (AutotoolsBuildResult *result)
+{
+  g_free (result);
+}
+
+/*
+ * Configs are read once per project and then served from memory. The 
+ * config folder is watched so that edits made outside of the properties 
+ * form are picked up. A reload updates the existing config in place 
+ * because the outputs hold on to it.
+ */
 static AutotoolsConfig*
 get_config_by_project (AutotoolsEngine   *engine, 
                        CodeSlayerProject *project)
 {
   AutotoolsEnginePrivate *priv;
-  AutotoolsConfig *config;
-  GKeyFile *key_file;
+  ConfigEntry *entry;
   gchar *folder_path;
-  gchar *file_path;
-  gchar *configure_file;
-  gchar *configure_parameters;
-  gchar *build_folder;
+  GFile *folder;
   
   priv = AUTOTOOLS_ENGINE_GET_PRIVATE (engine);
+  
+  entry = g_hash_table_lookup (priv->configs, project);
+  if (entry != NULL)
+    return entry->config;
 
   folder_path = codeslayer_get_project_config_folder_path (priv->codeslayer, project);
-  file_path = g_build_filename (folder_path, AUTOTOOLS_CONF, NULL);
+
+  entry = g_malloc (sizeof (ConfigEntry));
+  entry->engine = engine;
+  entry->project = project;
+  entry->file_path = g_build_filename (folder_path, AUTOTOOLS_CONF, NULL);
+  entry->config = NULL;
+  
+  folder = g_file_new_for_path (folder_path);
+  entry->monitor = g_file_monitor_directory (folder, G_FILE_MONITOR_NONE, NULL, NULL);
+  if (entry->monitor != NULL)
+    g_signal_connect (G_OBJECT (entry->monitor), "changed",
+                      G_CALLBACK (config_folder_changed_action), entry);
+  g_object_unref (folder);
+  g_free (folder_path);
+  
+  g_hash_table_insert (priv->configs, project, entry);
+  load_config (entry);
+  
+  return entry->config;
+}
+
+/*
+ * The [main] group holds the default configuration. Every further group 
+ * named "configuration <name>" is a named configuration of the same 
+ * project, which usually only sets its own build_folder and 
+ * configure_parameters and takes every other key from [main]. Named 
+ * configurations are updated in place by name for the same reason the 
+ * default one is.
+ */
+static void
+load_config (ConfigEntry *entry)
+{
+  AutotoolsConfig *config;
+  GKeyFile *key_file;
+  gchar **active_configurations;
+  GList *configurations = NULL;
+  gchar **groups;
+  gint i;
   
-  if (!codeslayer_utils_file_exists (file_path))
+  if (!codeslayer_utils_file_exists (entry->file_path))
     {
-      g_free (folder_path);
-      g_free (file_path);
-      return NULL;
+      if (entry->config != NULL)
+        {
+          g_object_unref (entry->config);
+          entry->config = NULL;
+        }
+      return;
     }
 
-  key_file = codeslayer_utils_get_key_file (file_path);
-  configure_file = g_key_file_get_string (key_file, MAIN, CONFIGURE_FILE, NULL);
-  configure_parameters = g_key_file_get_string (key_file, MAIN, CONFIGURE_PARAMETERS, NULL);
-  build_folder = g_key_file_get_string (key_file, MAIN, BUILD_FOLDER, NULL);
+  key_file = codeslayer_utils_get_key_file (entry->file_path);
+  
+  if (entry->config == NULL)
+    entry->config = autotools_config_new ();
+
+  config = entry->config;
+  autotools_config_set_project (config, entry->project);
+  read_config (config, key_file, MAIN);
+  
+  active_configurations = g_key_file_get_string_list (key_file, MAIN, ACTIVE_CONFIGURATIONS, NULL, NULL);
+  for (i = 0; active_configurations != NULL && active_configurations[i] != NULL; i++)
+    g_strstrip (active_configurations[i]);
+  autotools_config_set_active_configurations (config, active_configurations);
+  g_strfreev (active_configurations);
+  
+  groups = g_key_file_get_groups (key_file, NULL);
+  for (i = 0; groups[i] != NULL; i++)
+    {
+      AutotoolsConfig *configuration;
+      gchar *name;
+      
+      if (!g_str_has_prefix (groups[i], CONFIGURATION))
+        continue;
+      
+      name = g_strstrip (g_strdup (groups[i] + strlen (CONFIGURATION)));
+      if (*name == '\0' || g_strcmp0 (name, DEFAULT_CONFIGURATION) == 0)
+        {
+          g_free (name);
+          continue;
+        }
+      
+      configuration = autotools_config_get_configuration (config, name);
+      if (configuration != NULL)
+        {
+          g_object_ref (configuration);
+        }
+      else
+        {
+          configuration = autotools_config_new ();
+          autotools_config_set_name (configuration, name);
+        }
+      
+      autotools_config_set_project (configuration, entry->project);
+      read_config (configuration, key_file, groups[i]);
+      configurations = g_list_append (configurations, configuration);
+      g_free (name);
+    }
+  
+  autotools_config_set_configurations (config, configurations);
+  
+  g_list_free_full (configurations, g_object_unref);
+  g_strfreev (groups);
+  g_key_file_free (key_file);
+}
+
+/*
+ * Reads the settings of one configuration from its group, falling back 
+ * to [main] for every key that the group does not set.
+ */
+static void
+read_config (AutotoolsConfig *config,
+             GKeyFile        *key_file,
+             const gchar     *group)
+{
+  gchar *configure_file;
+  gchar *configure_parameters;
+  gchar *build_folder;
+  gint scrollback_lines;
+  gint scrollback_chars;
+  gchar *duplicate_build;
+  gint jobs;
+  gdouble load_average;
+  gchar **depends_on;
+  gchar *configure_cache;
+  gchar *compiler_launcher;
+  gboolean build_on_save;
+  gint build_on_save_delay;
+  gboolean profile_targets;
+  gchar **keys;
+  GPtrArray *environment;
+  gint i;
+  
+  configure_file = g_key_file_get_string (key_file, get_group (key_file, group, CONFIGURE_FILE), 
+                                          CONFIGURE_FILE, NULL);
+  configure_parameters = g_key_file_get_string (key_file, get_group (key_file, group, CONFIGURE_PARAMETERS), 
+                                                CONFIGURE_PARAMETERS, NULL);
+  build_folder = g_key_file_get_string (key_file, get_group (key_file, group, BUILD_FOLDER), 
+                                        BUILD_FOLDER, NULL);
+  scrollback_lines = g_key_file_get_integer (key_file, get_group (key_file, group, SCROLLBACK_LINES), 
+                                             SCROLLBACK_LINES, NULL);
+  scrollback_chars = g_key_file_get_integer (key_file, get_group (key_file, group, SCROLLBACK_CHARS), 
+                                             SCROLLBACK_CHARS, NULL);
+  duplicate_build = g_key_file_get_string (key_file, get_group (key_file, group, DUPLICATE_BUILD), 
+                                           DUPLICATE_BUILD, NULL);
+  jobs = g_key_file_get_integer (key_file, get_group (key_file, group, JOBS), JOBS, NULL);
+  load_average = g_key_file_get_double (key_file, get_group (key_file, group, LOAD_AVERAGE), 
+                                        LOAD_AVERAGE, NULL);
+  depends_on = g_key_file_get_string_list (key_file, get_group (key_file, group, DEPENDS_ON), 
+                                           DEPENDS_ON, NULL, NULL);
+  for (i = 0; depends_on != NULL && depends_on[i] != NULL; i++)
+    g_strstrip (depends_on[i]);
+  configure_cache = g_key_file_get_string (key_file, get_group (key_file, group, CONFIGURE_CACHE), 
+                                           CONFIGURE_CACHE, NULL);
+  compiler_launcher = g_key_file_get_string (key_file, get_group (key_file, group, COMPILER_LAUNCHER), 
+                                             COMPILER_LAUNCHER, NULL);
+  build_on_save = g_key_file_get_boolean (key_file, get_group (key_file, group, BUILD_ON_SAVE), 
+                                          BUILD_ON_SAVE, NULL);
+  build_on_save_delay = g_key_file_get_integer (key_file, get_group (key_file, group, BUILD_ON_SAVE_DELAY), 
+                                                BUILD_ON_SAVE_DELAY, NULL);
+  profile_targets = g_key_file_get_boolean (key_file, get_group (key_file, group, PROFILE_TARGETS), 
+                                            PROFILE_TARGETS, NULL);
+  
+  environment = g_ptr_array_new ();
+  keys = g_key_file_get_keys (key_file, ENVIRONMENT, NULL, NULL);
+  for (i = 0; keys != NULL && keys[i] != NULL; i++)
+    {
+      gchar *value;
+      value = g_key_file_get_string (key_file, ENVIRONMENT, keys[i], NULL);
+      g_ptr_array_add (environment, g_strconcat (keys[i], "=", value, NULL));
+      g_free (value);
+    }
+  g_ptr_array_add (environment, NULL);
+  g_strfreev (keys);
   
-  config = autotools_config_new ();
-  autotools_config_set_project (config, project);
   autotools_config_set_configure_file (config, configure_file);
   autotools_config_set_configure_parameters (config, configure_parameters);
   autotools_config_set_build_folder (config, build_folder);
+  autotools_config_set_scrollback_lines (config, scrollback_lines);
+  autotools_config_set_scrollback_chars (config, scrollback_chars);
+  if (g_strcmp0 (duplicate_build, DUPLICATE_BUILD_RESTART) == 0)
+    autotools_config_set_duplicate_build (config, AUTOTOOLS_DUPLICATE_BUILD_RESTART);
+  else
+    autotools_config_set_duplicate_build (config, AUTOTOOLS_DUPLICATE_BUILD_MERGE);
+  autotools_config_set_jobs (config, jobs);
+  autotools_config_set_load_average (config, load_average);
+  autotools_config_set_depends_on (config, depends_on);
+  if (g_strcmp0 (configure_cache, CONFIGURE_CACHE_PROJECT) == 0)
+    autotools_config_set_configure_cache (config, AUTOTOOLS_CONFIGURE_CACHE_PROJECT);
+  else if (g_strcmp0 (configure_cache, CONFIGURE_CACHE_SHARED) == 0)
+    autotools_config_set_configure_cache (config, AUTOTOOLS_CONFIGURE_CACHE_SHARED);
+  else
+    autotools_config_set_configure_cache (config, AUTOTOOLS_CONFIGURE_CACHE_NONE);
+  autotools_config_set_compiler_launcher (config, compiler_launcher);
+  autotools_config_set_build_on_save (config, build_on_save);
+  autotools_config_set_build_on_save_delay (config, build_on_save_delay);
+  autotools_config_set_profile_targets (config, profile_targets);
+  autotools_config_set_environment (config, (gchar **) environment->pdata);
   
-  g_free (folder_path);
-  g_free (file_path);
+  g_strfreev ((gchar **) g_ptr_array_free (environment, FALSE));
+  g_strfreev (depends_on);
+  g_free (configure_cache);
+  g_free (compiler_launcher);
   g_free (configure_file);
   g_free (configure_parameters);
   g_free (build_folder);
-  g_key_file_free (key_file);
+  g_free (duplicate_build);
+}
+
+static const gchar*
+get_group (GKeyFile    *key_file,
+           const gchar *group,
+           const gchar *key)
+{
+  if (g_key_file_has_key (key_file, group, key, NULL))
+    return group;
+  return MAIN;
+}
+
+static void
+config_folder_changed_action (GFileMonitor      *monitor,
+                              GFile             *file,
+                              GFile             *other_file,
+                              GFileMonitorEvent  event_type,
+                              ConfigEntry       *entry)
+{
+  gchar *basename;
   
-  return config;
+  if (event_type != G_FILE_MONITOR_EVENT_CHANGES_DONE_HINT &&
+      event_type != G_FILE_MONITOR_EVENT_CREATED &&
+      event_type != G_FILE_MONITOR_EVENT_DELETED)
+    return;
+  
+  basename = g_file_get_basename (file);
+  if (g_strcmp0 (basename, AUTOTOOLS_CONF) == 0)
+    load_config (entry);
+  g_free (basename);
+}
+
+static void
+destroy_config_entry (ConfigEntry *entry)
+{
+  if (entry->monitor != NULL)
+    {
+      g_signal_handlers_disconnect_by_func (entry->monitor, 
+                                            config_folder_changed_action, entry);
+      g_file_monitor_cancel (entry->monitor);
+      g_object_unref (entry->monitor);
+    }
+  if (entry->config != NULL)
+    g_object_unref (entry->config);
+  g_free (entry->file_path);
+  g_free (entry);
 }
 
 static void
@@ -255,8 +969,6 @@ project_properties_opened_action (AutotoolsEngine   *engine,
   config = get_config_by_project (engine, project);
   autotools_project_properties_opened (AUTOTOOLS_PROJECT_PROPERTIES (priv->project_properties),
                                        config, project);
-  if (config != NULL)
-    g_object_unref (config);                                       
 }
 
 static void
@@ -271,8 +983,6 @@ project_properties_saved_action (AutotoolsEngine   *engine,
   config = get_config_by_project (engine, project);
   autotools_project_properties_saved (AUTOTOOLS_PROJECT_PROPERTIES (priv->project_properties),
                                       config, project);
-  if (config != NULL)
-    g_object_unref (config);                                       
 }
 
 static void
@@ -287,10 +997,19 @@ save_config_action (AutotoolsEngine *engine,
   const gchar *configure_parameters;
   const gchar *build_folder;
   GKeyFile *key_file;
+  ConfigEntry *entry;
+  gchar **environment;
+  gchar **active_configurations;
  
   priv = AUTOTOOLS_ENGINE_GET_PRIVATE (engine);
 
   project = autotools_config_get_project (config);  
+  
+  get_config_by_project (engine, project);
+  entry = g_hash_table_lookup (priv->configs, project);
+  if (entry->config == NULL)
+    entry->config = g_object_ref (config);
+
   folder_path = codeslayer_get_project_config_folder_path (priv->codeslayer, project);
   file_path = codeslayer_utils_get_file_path (folder_path, AUTOTOOLS_CONF);
   key_file = codeslayer_utils_get_key_file (file_path);
@@ -301,6 +1020,47 @@ save_config_action (AutotoolsEngine *engine,
   g_key_file_set_string (key_file, MAIN, CONFIGURE_FILE, configure_file);
   g_key_file_set_string (key_file, MAIN, CONFIGURE_PARAMETERS, configure_parameters);
   g_key_file_set_string (key_file, MAIN, BUILD_FOLDER, build_folder);
+  if (autotools_config_get_jobs (config) > 0)
+    g_key_file_set_integer (key_file, MAIN, JOBS, autotools_config_get_jobs (config));
+  else
+    g_key_file_remove_key (key_file, MAIN, JOBS, NULL);
+  g_key_file_set_double (key_file, MAIN, LOAD_AVERAGE, autotools_config_get_load_average (config));
+  switch (autotools_config_get_configure_cache (config))
+    {
+    case AUTOTOOLS_CONFIGURE_CACHE_PROJECT:
+      g_key_file_set_string (key_file, MAIN, CONFIGURE_CACHE, CONFIGURE_CACHE_PROJECT);
+      break;
+    case AUTOTOOLS_CONFIGURE_CACHE_SHARED:
+      g_key_file_set_string (key_file, MAIN, CONFIGURE_CACHE, CONFIGURE_CACHE_SHARED);
+      break;
+    default:
+      g_key_file_remove_key (key_file, MAIN, CONFIGURE_CACHE, NULL);
+      break;
+    }
+  if (autotools_config_get_compiler_launcher (config) != NULL)
+    g_key_file_set_string (key_file, MAIN, COMPILER_LAUNCHER, 
+                           autotools_config_get_compiler_launcher (config));
+  g_key_file_set_boolean (key_file, MAIN, BUILD_ON_SAVE, autotools_config_get_build_on_save (config));
+  g_key_file_set_integer (key_file, MAIN, BUILD_ON_SAVE_DELAY, autotools_config_get_build_on_save_delay (config));
+  g_key_file_set_boolean (key_file, MAIN, PROFILE_TARGETS, autotools_config_get_profile_targets (config));
+  active_configurations = autotools_config_get_active_configurations (config);
+  if (active_configurations != NULL && *active_configurations != NULL)
+    g_key_file_set_string_list (key_file, MAIN, ACTIVE_CONFIGURATIONS, 
+                                (const gchar * const *) active_configurations, 
+                                g_strv_length (active_configurations));
+  else
+    g_key_file_remove_key (key_file, MAIN, ACTIVE_CONFIGURATIONS, NULL);
+  
+  g_key_file_remove_group (key_file, ENVIRONMENT, NULL);
+  environment = autotools_config_get_environment (config);
+  for (; environment != NULL && *environment != NULL; environment++)
+    {
+      gchar **pair;
+      pair = g_strsplit (*environment, "=", 2);
+      if (pair[0] != NULL && pair[1] != NULL)
+        g_key_file_set_string (key_file, ENVIRONMENT, pair[0], pair[1]);
+      g_strfreev (pair);
+    }
 
   codeslayer_utils_save_key_file (key_file, file_path);  
   g_key_file_free (key_file);
@@ -311,398 +1071,2826 @@ save_config_action (AutotoolsEngine *engine,
 static void
 make_action (AutotoolsEngine *engine)
 {
-  AutotoolsEnginePrivate *priv;
-  AutotoolsOutput *output;  
-
-  priv = AUTOTOOLS_ENGINE_GET_PRIVATE (engine);
+  GList *outputs;
 
-  output =  get_output_by_active_document (engine);
-  if (output)
-    {
-      codeslayer_show_bottom_pane (priv->codeslayer, priv->notebook);
-      autotools_notebook_select_page_by_output (AUTOTOOLS_NOTEBOOK (priv->notebook), 
-                                                GTK_WIDGET (output));
-      g_thread_new ("make", (GThreadFunc) execute_make, output);                                                
-    }
+  outputs = get_outputs_by_active_document (engine);
+  run_outputs (engine, outputs, execute_make);
+  g_list_free (outputs);
 }
 
 static void
 project_make_action (AutotoolsEngine *engine, 
                      GList           *selections)
 {
-  AutotoolsEnginePrivate *priv;
-  AutotoolsOutput *output;
-  CodeSlayerProject *project;
-
-  priv = AUTOTOOLS_ENGINE_GET_PRIVATE (engine);
-  
-  project = get_selections_project (selections);
-  output = get_output_by_project (engine, project);
-  if (output)
-    {
-      codeslayer_show_bottom_pane (priv->codeslayer, priv->notebook);
-      autotools_notebook_select_page_by_output (AUTOTOOLS_NOTEBOOK (priv->notebook), 
-                                                GTK_WIDGET (output));
-      g_thread_new ("project-make", (GThreadFunc) execute_make, output);                                                
-    }
+  run_selections (engine, selections, execute_make);
 }
 
 static void
 make_install_action (AutotoolsEngine *engine)
 {
-  AutotoolsEnginePrivate *priv;
-  AutotoolsOutput *output;  
-
-  priv = AUTOTOOLS_ENGINE_GET_PRIVATE (engine);
+  GList *outputs;
 
-  output =  get_output_by_active_document (engine);
-  if (output)
-    {
-      codeslayer_show_bottom_pane (priv->codeslayer, priv->notebook);
-      autotools_notebook_select_page_by_output (AUTOTOOLS_NOTEBOOK (priv->notebook), 
-                                                GTK_WIDGET (output));
-      g_thread_new ("make-install", (GThreadFunc) execute_make_install, output);                                                
-    }
+  outputs = get_outputs_by_active_document (engine);
+  run_outputs (engine, outputs, execute_make_install);
+  g_list_free (outputs);
 }   
 
 static void
 project_make_install_action (AutotoolsEngine *engine, 
                              GList           *selections)
 {
-  AutotoolsEnginePrivate *priv;
-  AutotoolsOutput *output;  
-  CodeSlayerProject *project;
-
-  priv = AUTOTOOLS_ENGINE_GET_PRIVATE (engine);
-  
-  project = get_selections_project (selections);
-  output =  get_output_by_project (engine, project);
-  if (output)
-    {
-      codeslayer_show_bottom_pane (priv->codeslayer, priv->notebook);
-      autotools_notebook_select_page_by_output (AUTOTOOLS_NOTEBOOK (priv->notebook), 
-                                                GTK_WIDGET (output));
-      g_thread_new ("project-make-install", (GThreadFunc) execute_make_install, output);                                                
-    }
-}   
+  run_selections (engine, selections, execute_make_install);
+}
 
 static void
 make_clean_action (AutotoolsEngine *engine)
 {
-  AutotoolsEnginePrivate *priv;
-  AutotoolsOutput *output;  
+  GList *outputs;
 
-  priv = AUTOTOOLS_ENGINE_GET_PRIVATE (engine);
-
-  output =  get_output_by_active_document (engine);
-  if (output)
-    {
-      codeslayer_show_bottom_pane (priv->codeslayer, priv->notebook);
-      autotools_notebook_select_page_by_output (AUTOTOOLS_NOTEBOOK (priv->notebook), 
-                                                GTK_WIDGET (output));
-      g_thread_new ("make-clean", (GThreadFunc) execute_make_clean, output);                                                
-    }
+  outputs = get_outputs_by_active_document (engine);
+  run_outputs (engine, outputs, execute_make_clean);
+  g_list_free (outputs);
 }
 
 static void
 project_make_clean_action (AutotoolsEngine *engine, 
                            GList           *selections)
 {
-  AutotoolsEnginePrivate *priv;
-  AutotoolsOutput *output;  
-  CodeSlayerProject *project;
-
-  priv = AUTOTOOLS_ENGINE_GET_PRIVATE (engine);
-  
-  project = get_selections_project (selections);
-  output =  get_output_by_project (engine, project);
-  if (output)
-    {
-      codeslayer_show_bottom_pane (priv->codeslayer, priv->notebook);
-      autotools_notebook_select_page_by_output (AUTOTOOLS_NOTEBOOK (priv->notebook), 
-                                                GTK_WIDGET (output));
-      g_thread_new ("project-make-clean", (GThreadFunc) execute_make_clean, output);                                                
-    }
+  run_selections (engine, selections, execute_make_clean);
 }
 
 static void
 project_configure_action (AutotoolsEngine *engine, 
                           GList           *selections)
 {
-  AutotoolsEnginePrivate *priv;
-  AutotoolsOutput *output;  
-  CodeSlayerProject *project;
-
-  priv = AUTOTOOLS_ENGINE_GET_PRIVATE (engine);
-  
-  project = get_selections_project (selections);
-  output =  get_output_by_project (engine, project);
-  if (output)
-    {
-      codeslayer_show_bottom_pane (priv->codeslayer, priv->notebook);
-      autotools_notebook_select_page_by_output (AUTOTOOLS_NOTEBOOK (priv->notebook), 
-                                                GTK_WIDGET (output));
-      g_thread_new ("project-configure", (GThreadFunc) execute_configure, output);                                                
-    }
+  run_selections (engine, selections, execute_configure);
 }
 
 static void
 project_autoreconf_action (AutotoolsEngine *engine, 
                            GList           *selections)
+{
+  run_selections (engine, selections, execute_autoreconf);
+}
+
+static void
+project_full_build_action (AutotoolsEngine *engine, 
+                           GList           *selections)
+{
+  run_selections (engine, selections, execute_full_build);
+}
+
+/*
+ * The active document has the same relative path in every configuration 
+ * of its project, so it is looked up once and then built in each of the 
+ * active ones.
+ */
+static void
+make_directory_action (AutotoolsEngine *engine)
 {
   AutotoolsEnginePrivate *priv;
-  AutotoolsOutput *output;  
-  CodeSlayerProject *project;
+  GList *outputs;
+  GList *list;
+  gchar *relative_path;
+  gchar *relative_folder;
 
   priv = AUTOTOOLS_ENGINE_GET_PRIVATE (engine);
+
+  outputs = get_outputs_by_active_document (engine);
+  if (outputs == NULL)
+    return;
   
-  project = get_selections_project (selections);
-  output =  get_output_by_project (engine, project);
-  if (output)
+  relative_path = get_active_document_relative_path (engine, outputs->data);
+  if (relative_path == NULL)
     {
-      codeslayer_show_bottom_pane (priv->codeslayer, priv->notebook);
-      autotools_notebook_select_page_by_output (AUTOTOOLS_NOTEBOOK (priv->notebook), 
-                                                GTK_WIDGET (output));
-      g_thread_new ("project-autoreconf", (GThreadFunc) execute_autoreconf, output);                                                
+      g_list_free (outputs);
+      return;
     }
-}
-
-static CodeSlayerProject*
-get_selections_project (GList *selections)
-{
-  if (selections != NULL)
+  
+  relative_folder = g_path_get_dirname (relative_path);
+  
+  codeslayer_show_bottom_pane (priv->codeslayer, priv->notebook);
+  autotools_notebook_select_page_by_output (AUTOTOOLS_NOTEBOOK (priv->notebook), 
+                                            GTK_WIDGET (outputs->data));
+  
+  for (list = outputs; list != NULL; list = list->next)
     {
-      CodeSlayerProjectsSelection *selection = selections->data;
-      return codeslayer_projects_selection_get_project (CODESLAYER_PROJECTS_SELECTION (selection));
+      AutotoolsConfig *config;
+      Command *command;
+      
+      config = autotools_output_get_config (list->data);
+      
+      command = new_command (config, NULL);
+      add_step (command, autotools_config_get_build_folder (config), 
+                get_make_argv (config, relative_folder, NULL), NULL);
+      run_command (engine, list->data, NULL, command);
     }
-  return NULL;  
+  
+  g_free (relative_folder);
+  g_free (relative_path);
+  g_list_free (outputs);
 }
 
 static void
-execute_make (AutotoolsOutput *output)
+compile_file_action (AutotoolsEngine *engine)
 {
-  AutotoolsConfig *config;
-  const gchar *build_folder;             
-  gchar *command;
+  AutotoolsEnginePrivate *priv;
+  GList *outputs;
+  GList *list;
+  gchar *relative_path;
 
-  config = autotools_output_get_config (output);
-  build_folder = autotools_config_get_build_folder (config);
+  priv = AUTOTOOLS_ENGINE_GET_PRIVATE (engine);
+
+  outputs = get_outputs_by_active_document (engine);
+  if (outputs == NULL)
+    return;
   
-  command = g_strconcat ("cd ", build_folder, ";make 2>&1", NULL);
-  run_command (output, command);
-  g_free (command);
+  relative_path = get_active_document_relative_path (engine, outputs->data);
+  if (relative_path == NULL)
+    {
+      g_list_free (outputs);
+      return;
+    }
+  
+  codeslayer_show_bottom_pane (priv->codeslayer, priv->notebook);
+  autotools_notebook_select_page_by_output (AUTOTOOLS_NOTEBOOK (priv->notebook), 
+                                            GTK_WIDGET (outputs->data));
+  
+  for (list = outputs; list != NULL; list = list->next)
+    {
+      AutotoolsConfig *config;
+      gchar *makefile_folder;
+      gchar *target;
+      Command *command;
+      
+      config = autotools_output_get_config (list->data);
+      target = get_object_target (autotools_config_get_build_folder (config), 
+                                  relative_path, &makefile_folder);
+      
+      command = new_command (config, NULL);
+      add_step (command, makefile_folder, get_make_argv (config, NULL, target), NULL);
+      run_command (engine, list->data, NULL, command);
+      
+      g_free (target);
+      g_free (makefile_folder);
+    }
+  
+  g_free (relative_path);
+  g_list_free (outputs);
 }
 
-static void
-execute_make_install (AutotoolsOutput *output)
+/*
+ * The path of the active document relative to the folder that holds the 
+ * configure file, which is also its path relative to the build folder.
+ */
+static gchar*
+get_active_document_relative_path (AutotoolsEngine *engine,
+                                   AutotoolsOutput *output)
 {
+  AutotoolsEnginePrivate *priv;
   AutotoolsConfig *config;
-  const gchar *build_folder;             
-  gchar *command;  
+  CodeSlayerDocument *document;
+  const gchar *file_path;
+  gchar *source_folder;
+  gchar *prefix;
+  gchar *relative_path = NULL;
+  
+  priv = AUTOTOOLS_ENGINE_GET_PRIVATE (engine);
   
   config = autotools_output_get_config (output);
-  build_folder = autotools_config_get_build_folder (config);
+  document = codeslayer_get_active_document (priv->codeslayer);
+  file_path = codeslayer_document_get_file_path (document);
   
-  command = g_strconcat ("cd ", build_folder, ";make install 2>&1", NULL);
-  run_command (output, command);
-  g_free (command);   
-}
+  source_folder = g_path_get_dirname (autotools_config_get_configure_file (config));
+  prefix = g_strconcat (source_folder, G_DIR_SEPARATOR_S, NULL);
+  
+  if (file_path != NULL && g_str_has_prefix (file_path, prefix))
+    {
+      relative_path = g_strdup (file_path + strlen (prefix));
+    }
+  else
+    {
+      GtkWidget *dialog;
+      dialog =  gtk_message_dialog_new (NULL, 
+                                        GTK_DIALOG_MODAL,
+                                        GTK_MESSAGE_ERROR, GTK_BUTTONS_OK,
+                                        "The active document is not under %s.", 
+                                        source_folder);
+      gtk_dialog_run (GTK_DIALOG (dialog));
+      gtk_widget_destroy (dialog);
+    }
+  
+  g_free (prefix);
+  g_free (source_folder);
+  return relative_path;
+}
 
-static void
-execute_make_clean (AutotoolsOutput *output)
+/*
+ * Automake names objects after the source file, optionally prefixed with 
+ * the target when it has its own flags, and with .lo for libtool. The 
+ * real name is looked up in the generated Makefile of the source's 
+ * folder, or of a parent folder when subdir-objects is used. When no 
+ * name is found a plain .o is assumed.
+ */
+static gchar*
+get_object_target (const gchar  *build_folder,
+                   const gchar  *relative_path,
+                   gchar       **makefile_folder)
 {
-  AutotoolsConfig *config;
-  const gchar *build_folder;             
-  gchar *command;
+  gchar *relative_folder;
+  gchar *basename;
+  gchar *stem;
+  gchar *dot;
+  gchar *target = NULL;
   
-  config = autotools_output_get_config (output);
-  build_folder = autotools_config_get_build_folder (config);
+  relative_folder = g_path_get_dirname (relative_path);
+  basename = g_path_get_basename (relative_path);
+  stem = g_strdup (basename);
+  dot = strrchr (stem, '.');
+  if (dot != NULL)
+    *dot = '\0';
   
-  command = g_strconcat ("cd ", build_folder, ";make clean 2>&1", NULL);
-  run_command (output, command);
-  g_free (command);
+  while (TRUE)
+    {
+      gchar *folder;
+      gchar *prefix;
+      gchar *parent;
+      
+      if (g_strcmp0 (relative_folder, ".") == 0)
+        folder = g_strdup (build_folder);
+      else
+        folder = g_build_filename (build_folder, relative_folder, NULL);
+      
+      prefix = get_relative_prefix (relative_path, relative_folder);
+      target = find_object_target (folder, prefix, stem);
+      g_free (prefix);
+      
+      if (target != NULL || g_strcmp0 (relative_folder, ".") == 0)
+        {
+          *makefile_folder = folder;
+          break;
+        }
+      
+      g_free (folder);
+      parent = g_path_get_dirname (relative_folder);
+      g_free (relative_folder);
+      relative_folder = parent;
+    }
+  
+  if (target == NULL)
+    {
+      gchar *source_folder;
+      source_folder = g_path_get_dirname (relative_path);
+      g_free (*makefile_folder);
+      if (g_strcmp0 (source_folder, ".") == 0)
+        *makefile_folder = g_strdup (build_folder);
+      else
+        *makefile_folder = g_build_filename (build_folder, source_folder, NULL);
+      target = g_strconcat (stem, ".o", NULL);
+      g_free (source_folder);
+    }
+  
+  g_free (relative_folder);
+  g_free (basename);
+  g_free (stem);
+  
+  return target;
 }
 
-static void
-execute_configure (AutotoolsOutput *output)
+static gchar*
+get_relative_prefix (const gchar *relative_path,
+                     const gchar *relative_folder)
 {
-  AutotoolsConfig *config;
-  const gchar *build_folder;
-  const gchar *configure_file;             
-  const gchar *configure_parameters;             
-  gchar *configure_file_path;             
-  gchar *command;
+  gchar *source_folder;
+  gchar *prefix;
   
-  config = autotools_output_get_config (output);
-  build_folder = autotools_config_get_build_folder (config);
-  configure_file = autotools_config_get_configure_file (config);
-  configure_file_path = g_path_get_dirname (configure_file);
-  configure_parameters = autotools_config_get_configure_parameters (config);
+  source_folder = g_path_get_dirname (relative_path);
+  
+  if (g_strcmp0 (source_folder, relative_folder) == 0)
+    prefix = g_strdup ("");
+  else if (g_strcmp0 (relative_folder, ".") == 0)
+    prefix = g_strconcat (source_folder, "/", NULL);
+  else
+    prefix = g_strconcat (source_folder + strlen (relative_folder) + 1, "/", NULL);
+  
+  g_free (source_folder);
+  return prefix;
+}
+
+static gchar*
+find_object_target (const gchar *folder,
+                    const gchar *prefix,
+                    const gchar *stem)
+{
+  const gchar *extensions[] = {".lo", ".$(OBJEXT)", ".o", NULL};
+  gchar *makefile_path;
+  gchar *contents;
+  gchar **tokens;
+  gchar **token;
+  gchar *target = NULL;
+  
+  makefile_path = g_build_filename (folder, "Makefile", NULL);
+  if (!g_file_get_contents (makefile_path, &contents, NULL, NULL))
+    {
+      g_free (makefile_path);
+      return NULL;
+    }
+  
+  tokens = g_strsplit_set (contents, " \t\n\\:", -1);
+  
+  for (token = tokens; target == NULL && *token != NULL; token++)
+    {
+      const gchar *name;
+      gint i;
+      
+      if (!g_str_has_prefix (*token, prefix))
+        continue;
+      
+      name = *token + strlen (prefix);
+      if (strchr (name, '/') != NULL)
+        continue;
+        
+      for (i = 0; extensions[i] != NULL; i++)
+        {
+          gchar *object;
+          gchar *suffix;
+          
+          object = g_strconcat (stem, extensions[i], NULL);
+          suffix = g_strconcat ("-", object, NULL);
+          
+          if (g_strcmp0 (name, object) == 0 || g_str_has_suffix (name, suffix))
+            {
+              if (g_str_has_suffix (*token, ".$(OBJEXT)"))
+                {
+                  gchar *object_name;
+                  object_name = g_strndup (*token, strlen (*token) - strlen (".$(OBJEXT)"));
+                  target = g_strconcat (object_name, ".o", NULL);
+                  g_free (object_name);
+                }
+              else
+                {
+                  target = g_strdup (*token);
+                }
+            }
+          
+          g_free (suffix);
+          g_free (object);
+          
+          if (target != NULL)
+            break;
+        }
+    }
+  
+  g_strfreev (tokens);
+  g_free (contents);
+  g_free (makefile_path);
+  
+  return target;
+}
+
+static void
+stop_action (AutotoolsEngine *engine)
+{
+  GList *outputs;
+  GList *list;
+
+  outputs = get_outputs_by_active_document (engine);
+  for (list = outputs; list != NULL; list = list->next)
+    output_stop_action (engine, list->data);
+  g_list_free (outputs);
+}
+
+static void
+output_stop_action (AutotoolsEngine *engine,
+                    AutotoolsOutput *output)
+{
+  AutotoolsEnginePrivate *priv;
+  Build *build;
+
+  priv = AUTOTOOLS_ENGINE_GET_PRIVATE (engine);
   
-  command = g_strconcat ("cd ", build_folder, ";", configure_file_path, 
-                         G_DIR_SEPARATOR_S, "configure ", configure_parameters, " 2>&1", NULL);
-  g_free (configure_file_path);    
+  build = g_hash_table_lookup (priv->builds, output);
+  if (build == NULL)
+    return;
 
-  run_command (output, command);
-  g_free (command);    
+  if (build->pending_command != NULL)
+    destroy_command (build->pending_command);
+  build->pending_command = NULL;
+
+  if (build->process == NULL)
+    {
+      g_queue_remove (priv->waiting, build);
+      autotools_output_append_text (output, "stopped\n", -1);
+      build->succeeded = FALSE;
+      remove_build (build);
+    }
+  else if (autotools_process_is_running (build->process))
+    {
+      build->stopped = TRUE;
+      autotools_process_stop (build->process);
+    }
 }
 
 static void
-execute_autoreconf (AutotoolsOutput *output)
+output_export_trace_action (AutotoolsEngine *engine,
+                            AutotoolsOutput *output)
 {
+  AutotoolsEnginePrivate *priv;
   AutotoolsConfig *config;
-  const gchar *configure_file;             
-  gchar *configure_file_path;             
-  gchar *command;
-  OutputContext *context;
+  const gchar *build_folder;
+  gchar *log_path;
+  gchar *trace_path;
+  gchar *text;
+  GError *error = NULL;
+
+  priv = AUTOTOOLS_ENGINE_GET_PRIVATE (engine);
+  
+  if (g_hash_table_lookup (priv->builds, output) != NULL)
+    {
+      autotools_output_append_text (output, "the trace can be exported once the build finishes\n", -1);
+      return;
+    }
   
   config = autotools_output_get_config (output);
-  configure_file = autotools_config_get_configure_file (config);
-  configure_file_path = g_path_get_dirname (configure_file);
+  build_folder = autotools_config_get_build_folder (config);
   
-  command = g_strconcat ("cd ", configure_file_path, ";autoreconf 2>&1", NULL);
-  g_free (configure_file_path);
+  log_path = g_build_filename (build_folder, AUTOTOOLS_TIMING_LOG, NULL);
+  trace_path = g_build_filename (build_folder, AUTOTOOLS_TIMING_TRACE, NULL);
+  
+  if (!g_file_test (log_path, G_FILE_TEST_EXISTS))
+    text = g_strdup ("no trace was recorded, turn on Profile Targets and build again\n");
+  else if (autotools_timing_write_trace (log_path, trace_path, &error))
+    text = g_strdup_printf ("trace written to %s\n", trace_path);
+  else
+    {
+      text = g_strdup_printf ("%s\n", error->message);
+      g_error_free (error);
+    }
 
-  run_command (output, command);
-  g_free (command);
+  autotools_output_append_text (output, text, -1);
   
-  context = g_malloc (sizeof (OutputContext));
-  context->output = output;
-  context->text = g_strdup ("autoreconf finished\n");
-  g_idle_add_full (G_PRIORITY_DEFAULT_IDLE, (GSourceFunc) append_text, context, (GDestroyNotify)destroy_text);
+  g_free (text);
+  g_free (log_path);
+  g_free (trace_path);
 }
 
-static AutotoolsOutput*
-get_output_by_active_document (AutotoolsEngine *engine)
+/*
+ * Closing a tab destroys its output, so everything the engine keeps for 
+ * it is dropped here without writing to it again. A running build is 
+ * stopped and its callers get a cancelled error. In a batch the projects 
+ * that depend on it are cancelled the same way as when it fails.
+ */
+static void
+output_destroyed_action (AutotoolsOutput *output,
+                         AutotoolsEngine *engine)
 {
   AutotoolsEnginePrivate *priv;
-  CodeSlayer *codeslayer;
-  CodeSlayerProject *project;
-  
+  Build *build;
+  GList *batches;
+  GList *list;
+
   priv = AUTOTOOLS_ENGINE_GET_PRIVATE (engine);
-  codeslayer = priv->codeslayer;
   
-  project = codeslayer_get_active_document_project (codeslayer);
-  if (project == NULL)
+  g_hash_table_remove (priv->launcher_reads, output);
+  
+  build = g_hash_table_lookup (priv->builds, output);
+  if (build != NULL)
     {
-      GtkWidget *dialog;
-      dialog =  gtk_message_dialog_new (NULL, 
-                                        GTK_DIALOG_MODAL,
-                                        GTK_MESSAGE_ERROR, GTK_BUTTONS_OK,
-                                        "There are no open documents. Not able to determine what project to execute command against.");
-      gtk_dialog_run (GTK_DIALOG (dialog));
-      gtk_widget_destroy (dialog);
-      return NULL;
+      g_queue_remove (priv->waiting, build);
+      if (build->process != NULL)
+        {
+          AutotoolsBuildResult *result;
+          autotools_process_stop (build->process);
+          build->stopped = TRUE;
+          priv->running_slots -= build->slots;
+          result = new_build_result (build, -1);
+          g_signal_emit_by_name ((gpointer) engine, "build-finished", result->project, result);
+          autotools_build_result_free (result);
+        }
+      g_hash_table_remove (priv->builds, output);
     }
-
-  return get_output_by_project (engine, project);
+  
+  batches = g_list_copy (priv->batches);
+  for (list = batches; list != NULL; list = list->next)
+    {
+      Batch *batch = list->data;
+      BatchNode *node;
+      GList *dependents;
+      gchar *text;
+      
+      node = g_hash_table_lookup (batch->nodes, output);
+      if (node == NULL || node->finished)
+        continue;
+      
+      node->finished = TRUE;
+      text = g_strdup_printf ("cancelled, %s was closed\n", node->name);
+      for (dependents = node->dependents; dependents != NULL; dependents = dependents->next)
+        cancel_batch_node (batch, dependents->data, text);
+      g_free (text);
+      release_batch (batch, NULL);
+    }
+  g_list_free (batches);
+  
+  schedule_builds (engine);
 }
 
-static AutotoolsOutput*
-get_output_by_project (AutotoolsEngine   *engine, 
-                       CodeSlayerProject *project)
+/*
+ * Saves that arrive in a burst, such as a save all, restart the timer so 
+ * that make only runs once the project has been quiet for the configured 
+ * delay. A build that is still running for the project is stopped first 
+ * because its result is already out of date.
+ */
+static void
+document_saved_action (AutotoolsEngine    *engine,
+                       CodeSlayerDocument *document)
 {
   AutotoolsEnginePrivate *priv;
-  GtkWidget  *notebook;
-  const gchar *project_name;
+  CodeSlayerProject *project;
   AutotoolsConfig *config;
-  GtkWidget *output;
+  SaveTimer *save_timer;
   
   priv = AUTOTOOLS_ENGINE_GET_PRIVATE (engine);
-  notebook = priv->notebook;
   
-  project_name = codeslayer_project_get_name (project);
+  project = codeslayer_document_get_project (document);
+  if (project == NULL)
+    return;
+    
   config = get_config_by_project (engine, project);
+  if (config == NULL || !autotools_config_get_build_on_save (config))
+    return;
   
-  if (config == NULL)
+  save_timer = g_hash_table_lookup (priv->save_timers, project);
+  if (save_timer == NULL)
     {
-      GtkWidget *dialog;
-      gchar *msg;
-      msg = g_strconcat ("There is no config for project ", 
-                         project_name, ".", NULL);      
-      dialog =  gtk_message_dialog_new (NULL, 
-                                        GTK_DIALOG_MODAL,
-                                        GTK_MESSAGE_ERROR, GTK_BUTTONS_OK,
-                                        msg, 
-                                        NULL);
-      gtk_dialog_run (GTK_DIALOG (dialog));
-      gtk_widget_destroy (dialog);
-      g_free (msg);
-      return NULL;
+      save_timer = g_malloc (sizeof (SaveTimer));
+      save_timer->engine = engine;
+      save_timer->project = project;
+      save_timer->source_id = 0;
+      g_hash_table_insert (priv->save_timers, project, save_timer);
     }
   
-  output = autotools_notebook_get_output_by_config (AUTOTOOLS_NOTEBOOK (notebook), 
-                                                    config);
-  if (output == NULL)
+  if (save_timer->source_id != 0)
+    g_source_remove (save_timer->source_id);
+    
+  save_timer->source_id = g_timeout_add (autotools_config_get_build_on_save_delay (config), 
+                                         (GSourceFunc) build_on_save_action, save_timer);
+}
+
+static gboolean
+build_on_save_action (SaveTimer *save_timer)
+{
+  AutotoolsEngine *engine;
+  GList *outputs;
+  GList *list;
+  
+  engine = save_timer->engine;
+  save_timer->source_id = 0;
+  
+  outputs = get_outputs_by_project (engine, save_timer->project);
+  for (list = outputs; list != NULL; list = list->next)
     {
-      output = autotools_output_new (config, priv->codeslayer);
-      autotools_notebook_add_output (AUTOTOOLS_NOTEBOOK (priv->notebook), output, 
-                                                         project_name);
-    }                                                           
+      output_stop_action (engine, list->data);
+      execute_make (engine, list->data, NULL);
+    }
+  g_list_free (outputs);
+    
+  return FALSE;
+}
 
-  return AUTOTOOLS_OUTPUT (output);
+static void
+destroy_save_timer (SaveTimer *save_timer)
+{
+  if (save_timer->source_id != 0)
+    g_source_remove (save_timer->source_id);
+  g_free (save_timer);
 }
 
+/*
+ * Every active configuration of the selected projects gets built in its 
+ * own tab. Autoreconf works on the source folder, which the 
+ * configurations of a project share, so it only runs once per project.
+ */
 static void
-run_command (AutotoolsOutput *output,
-             gchar           *command)
+run_selections (AutotoolsEngine *engine, 
+                GList           *selections,
+                ExecuteFunc      execute)
 {
-  char out[BUFSIZ];
-  FILE *file;
-  
-  g_idle_add ((GSourceFunc) clear_text, output);
+  GList *outputs = NULL;
+  GList *list;
   
-  file = popen (command, "r");
-  if (file != NULL)
+  for (list = selections; list != NULL; list = list->next)
     {
-      while (fgets (out, BUFSIZ, file))
+      CodeSlayerProjectsSelection *selection = list->data;
+      CodeSlayerProject *project;
+      GList *project_outputs;
+      GList *item;
+      
+      project = codeslayer_projects_selection_get_project (CODESLAYER_PROJECTS_SELECTION (selection));
+      project_outputs = get_outputs_by_project (engine, project);
+      if (execute == execute_autoreconf && project_outputs != NULL)
         {
-          OutputContext *context;
-          context = g_malloc (sizeof (OutputContext));
-          context->output = output;
-          context->text = g_strdup (out);
-          g_idle_add_full (G_PRIORITY_DEFAULT_IDLE, (GSourceFunc) append_text, 
-                           context, (GDestroyNotify)destroy_text);
+          g_list_free (project_outputs->next);
+          project_outputs->next = NULL;
         }
-      pclose (file);
+      
+      for (item = project_outputs; item != NULL; item = item->next)
+        if (g_list_find (outputs, item->data) == NULL)
+          outputs = g_list_append (outputs, item->data);
+      g_list_free (project_outputs);
     }
+  
+  run_outputs (engine, outputs, execute);
+  g_list_free (outputs);
+}
+
+/*
+ * When more than one build is involved the builds share a batch, which 
+ * orders them by the depends_on lists in their configs and reports the 
+ * total wall time once the last of them is done.
+ */
+static void
+run_outputs (AutotoolsEngine *engine, 
+             GList           *outputs,
+             ExecuteFunc      execute)
+{
+  AutotoolsEnginePrivate *priv;
+  Batch *batch;
+
+  priv = AUTOTOOLS_ENGINE_GET_PRIVATE (engine);
     
-  g_idle_add ((GSourceFunc) create_links, output);
+  if (outputs == NULL)
+    return;
+
+  codeslayer_show_bottom_pane (priv->codeslayer, priv->notebook);
+  autotools_notebook_select_page_by_output (AUTOTOOLS_NOTEBOOK (priv->notebook), 
+                                            GTK_WIDGET (outputs->data));
+  
+  if (outputs->next == NULL)
+    {
+      execute (engine, AUTOTOOLS_OUTPUT (outputs->data), NULL);
+    }
+  else
+    {
+      batch = new_batch (engine, execute, outputs);
+      start_batch (batch, outputs);
+    }
 }
 
-static gboolean 
-clear_text (AutotoolsOutput *output)
+static void
+execute_make (AutotoolsEngine *engine,
+              AutotoolsOutput *output,
+              Batch           *batch)
 {
-  GtkTextBuffer *buffer;
-  buffer = gtk_text_view_get_buffer (GTK_TEXT_VIEW (output));
-  gtk_text_buffer_set_text (buffer, "", -1);
-  return FALSE;
+  AutotoolsConfig *config;
+  Command *command;
+  
+  config = autotools_output_get_config (output);
+  
+  command = new_command (config, NULL);
+  add_step (command, autotools_config_get_build_folder (config), 
+            get_make_argv (config, NULL, NULL), NULL);
+  run_command (engine, output, batch, command);
 }
 
-static gboolean 
-append_text (OutputContext *context)
+static void
+execute_make_install (AutotoolsEngine *engine,
+                      AutotoolsOutput *output,
+                      Batch           *batch)
 {
-  GtkTextBuffer *buffer;
-  GtkTextIter iter;
-  GtkTextMark *text_mark;
-  buffer = gtk_text_view_get_buffer (GTK_TEXT_VIEW (context->output));
-  gtk_text_buffer_get_end_iter (buffer, &iter);
-  gtk_text_buffer_insert (buffer, &iter, context->text, -1);
-  text_mark = gtk_text_buffer_create_mark (buffer, NULL, &iter, TRUE);
-  gtk_text_view_scroll_to_mark (GTK_TEXT_VIEW (context->output), text_mark, 0.0, FALSE, 0, 0);
-  return FALSE;
+  AutotoolsConfig *config;
+  Command *command;
+  
+  config = autotools_output_get_config (output);
+  
+  command = new_command (config, NULL);
+  add_step (command, autotools_config_get_build_folder (config), 
+            get_make_argv (config, NULL, "install"), NULL);
+  run_command (engine, output, batch, command);
 }
 
-static void 
-destroy_text (OutputContext *context)
+static void
+execute_make_clean (AutotoolsEngine *engine,
+                    AutotoolsOutput *output,
+                    Batch           *batch)
 {
-  g_free (context->text);
-  g_free (context);
+  AutotoolsConfig *config;
+  Command *command;
+  
+  config = autotools_output_get_config (output);
+  
+  command = new_command (config, NULL);
+  add_step (command, autotools_config_get_build_folder (config), 
+            get_make_argv (config, NULL, "clean"), NULL);
+  run_command (engine, output, batch, command);
 }
 
-static gboolean 
-create_links (AutotoolsOutput *output)
+/*
+ * A project that does not set its jobs, or sets 0, runs as many as the 
+ * machine it is built on has processors. Only an explicit number is 
+ * stored, so the config follows the project from machine to machine.
+ */
+static gint
+get_jobs (AutotoolsConfig *config)
 {
-  autotools_output_create_links (output);
-  return FALSE;
+  gint jobs;
+  jobs = autotools_config_get_jobs (config);
+  return jobs > 0 ? jobs : (gint) g_get_num_processors ();
+}
+
+/*
+ * Make is always run with -w so that every sub-make reports the folder 
+ * it works in. The diagnostics scanner needs that to resolve the file 
+ * names of a recursive build, which are relative to each sub-make.
+ */
+static gchar**
+get_make_argv (AutotoolsConfig *config,
+               const gchar     *directory,
+               const gchar     *target)
+{
+  GPtrArray *argv;
+  gdouble load_average;
+  
+  argv = g_ptr_array_new ();
+  g_ptr_array_add (argv, g_strdup ("make"));
+  g_ptr_array_add (argv, g_strdup ("-w"));
+  g_ptr_array_add (argv, g_strdup_printf ("-j%d", get_jobs (config)));
+  
+  load_average = autotools_config_get_load_average (config);
+  if (load_average > 0)
+    {
+      gchar buffer[G_ASCII_DTOSTR_BUF_SIZE];
+      g_ascii_formatd (buffer, sizeof (buffer), "%.2f", load_average);
+      g_ptr_array_add (argv, g_strconcat ("-l", buffer, NULL));
+    }
+
+  if (autotools_config_get_profile_targets (config) && autotools_timing_get_shell () != NULL)
+    g_ptr_array_add (argv, g_strconcat ("SHELL=", autotools_timing_get_shell (), " $@", NULL));
+  
+  if (directory != NULL)
+    {
+      g_ptr_array_add (argv, g_strdup ("-C"));
+      g_ptr_array_add (argv, g_strdup (directory));
+    }
+
+  if (target != NULL)
+    g_ptr_array_add (argv, g_strdup (target));
+  
+  g_ptr_array_add (argv, NULL);
+  return (gchar **) g_ptr_array_free (argv, FALSE);
+}
+
+/*
+ * The configure parameters are split into words following the shell's 
+ * quoting rules, the same way they were read when configure was run 
+ * through a shell, and $NAME or ${NAME} in each word is then replaced 
+ * from the environment of the command. A word is not split again after 
+ * that. Parameters the shell could not have read give an error.
+ */
+static gchar**
+get_configure_argv (AutotoolsEngine  *engine,
+                    AutotoolsConfig  *config,
+                    const gchar      *configure_path,
+                    gchar           **envp,
+                    GError          **error)
+{
+  const gchar *configure_parameters;             
+  GPtrArray *argv;
+  gchar **parameters = NULL;
+  gchar *cache_file_option;
+  gint i;
+  
+  configure_parameters = autotools_config_get_configure_parameters (config);
+  if (configure_parameters != NULL && *configure_parameters != '\0' &&
+      !g_shell_parse_argv (configure_parameters, NULL, &parameters, error))
+    return NULL;
+  
+  argv = g_ptr_array_new ();
+  g_ptr_array_add (argv, g_strdup (configure_path));
+  
+  for (i = 0; parameters != NULL && parameters[i] != NULL; i++)
+    g_ptr_array_add (argv, expand_variables (parameters[i], envp));
+  g_strfreev (parameters);
+  
+  autotools_launcher_wrap_configure_arguments (autotools_config_get_compiler_launcher (config), 
+                                               argv, envp);
+  
+  cache_file_option = get_cache_file_option (engine, config, envp);
+  if (cache_file_option != NULL)
+    g_ptr_array_add (argv, cache_file_option);
+  
+  g_ptr_array_add (argv, NULL);
+  return (gchar **) g_ptr_array_free (argv, FALSE);
+}
+
+/*
+ * Nothing is started when the configure parameters cannot be read. The 
+ * reason goes to the output, and a batch carries on as if configure 
+ * had failed.
+ */
+static void
+report_configure_error (AutotoolsOutput *output,
+                        Batch           *batch,
+                        GError          *error)
+{
+  gchar *text;
+  
+  text = g_strdup_printf ("configure parameters: %s\n", error->message);
+  autotools_output_append_text (output, text, -1);
+  g_free (text);
+  g_error_free (error);
+  
+  if (batch != NULL)
+    finish_batch (batch, output, FALSE);
+}
+
+static void
+execute_configure (AutotoolsEngine *engine,
+                   AutotoolsOutput *output,
+                   Batch           *batch)
+{
+  AutotoolsConfig *config;
+  gchar *source_folder;             
+  gchar *configure_path;             
+  gchar *checksum;
+  gchar **argv;
+  Command *command;
+  Step *step;
+  GError *error = NULL;
+  
+  config = autotools_output_get_config (output);
+  source_folder = g_path_get_dirname (autotools_config_get_configure_file (config));
+  configure_path = g_build_filename (source_folder, "configure", NULL);
+  
+  command = new_command (config, NULL);
+  argv = get_configure_argv (engine, config, configure_path, command->envp, &error);
+  if (argv == NULL)
+    {
+      report_configure_error (output, batch, error);
+      destroy_command (command);
+      g_free (configure_path);
+      g_free (source_folder);
+      return;
+    }
+  
+  step = add_step (command, autotools_config_get_build_folder (config), argv, NULL);
+  step->stamp_path = g_build_filename (autotools_config_get_build_folder (config), 
+                                       CONFIGURE_STAMP, NULL);
+  step->cache_path = get_configure_cache_path (engine, config, command->envp);
+  checksum = get_configure_checksum (config);
+  step->stamp = g_strconcat (checksum, "\n", NULL);
+  run_command (engine, output, batch, command);
+  
+  g_free (checksum);
+  g_free (configure_path);
+  g_free (source_folder);
+}
+
+static void
+execute_autoreconf (AutotoolsEngine *engine,
+                    AutotoolsOutput *output,
+                    Batch           *batch)
+{
+  AutotoolsConfig *config;
+  gchar *source_folder;             
+  gchar **argv;
+  Command *command;
+  
+  config = autotools_output_get_config (output);
+  source_folder = g_path_get_dirname (autotools_config_get_configure_file (config));
+  
+  argv = g_new0 (gchar*, 2);
+  argv[0] = g_strdup ("autoreconf");
+  
+  command = new_command (config, "autoreconf finished\n");
+  add_step (command, source_folder, argv, NULL);
+  run_command (engine, output, batch, command);
+  
+  g_free (source_folder);
+}
+
+/*
+ * Runs autoreconf, configure and make as the steps of one command so that 
+ * the first stage to fail stops the rest. The stages that are already up 
+ * to date are left out: autoreconf when configure is newer than all of 
+ * its inputs, and configure when config.status is newer than configure 
+ * and was produced with the same configure parameters.
+ */
+static void
+execute_full_build (AutotoolsEngine *engine,
+                    AutotoolsOutput *output,
+                    Batch           *batch)
+{
+  AutotoolsConfig *config;
+  const gchar *build_folder;
+  gchar *source_folder;             
+  gchar *configure_path;
+  gchar *stamp_path;
+  gchar *checksum;
+  gboolean run_autoreconf;
+  gboolean run_configure;
+  Command *command;
+  
+  config = autotools_output_get_config (output);
+  build_folder = autotools_config_get_build_folder (config);
+  source_folder = g_path_get_dirname (autotools_config_get_configure_file (config));
+  configure_path = g_build_filename (source_folder, "configure", NULL);
+  stamp_path = g_build_filename (build_folder, CONFIGURE_STAMP, NULL);
+  checksum = get_configure_checksum (config);
+  
+  run_autoreconf = autoreconf_needed (source_folder);
+  run_configure = run_autoreconf || configure_needed (configure_path, build_folder, 
+                                                      stamp_path, checksum);
+  
+  command = new_command (config, NULL);
+  
+  if (run_autoreconf)
+    {
+      gchar **argv;
+      argv = g_new0 (gchar*, 2);
+      argv[0] = g_strdup ("autoreconf");
+      add_step (command, source_folder, argv, NULL);
+    }
+  else
+    {
+      add_step (command, NULL, NULL, "autoreconf is up to date\n");
+    }
+  
+  if (run_configure)
+    {
+      GError *error = NULL;
+      gchar **argv;
+      
+      argv = get_configure_argv (engine, config, configure_path, command->envp, &error);
+      if (argv == NULL)
+        {
+          report_configure_error (output, batch, error);
+          destroy_command (command);
+          command = NULL;
+        }
+      else
+        {
+          Step *step;
+          step = add_step (command, build_folder, argv, NULL);
+          step->stamp_path = g_strdup (stamp_path);
+          step->cache_path = get_configure_cache_path (engine, config, command->envp);
+          step->stamp = g_strconcat (checksum, "\n", NULL);
+        }
+    }
+  else
+    {
+      add_step (command, NULL, NULL, "configure is up to date\n");
+    }
+  
+  if (command != NULL)
+    {
+      add_step (command, build_folder, get_make_argv (config, NULL, NULL), NULL);
+      run_command (engine, output, batch, command);
+    }
+  
+  g_free (checksum);
+  g_free (stamp_path);
+  g_free (configure_path);
+  g_free (source_folder);
+}
+
+static gchar*
+get_configure_checksum (AutotoolsConfig *config)
+{
+  GString *text;
+  gchar **environment;
+  gchar *checksum;
+  
+  text = g_string_new (NULL);
+  g_string_append_printf (text, "%s\n%s\n%s\n", autotools_config_get_configure_file (config), 
+                          autotools_config_get_configure_parameters (config) != NULL ? 
+                          autotools_config_get_configure_parameters (config) : "", 
+                          autotools_config_get_compiler_launcher (config) != NULL ? 
+                          autotools_config_get_compiler_launcher (config) : "");
+  
+  environment = autotools_config_get_environment (config);
+  for (; environment != NULL && *environment != NULL; environment++)
+    g_string_append_printf (text, "%s\n", *environment);
+  
+  checksum = g_compute_checksum_for_string (G_CHECKSUM_SHA1, text->str, text->len);
+  g_string_free (text, TRUE);
+  
+  return checksum;
+}
+
+static gboolean
+get_modified_time (const gchar *file_path,
+                   time_t      *mtime)
+{
+  GStatBuf buf;
+  
+  if (g_stat (file_path, &buf) != 0)
+    return FALSE;
+    
+  *mtime = buf.st_mtime;
+  return TRUE;
+}
+
+/*
+ * autoreconf has to run again when configure is older than one of the 
+ * files it is generated from: configure.ac or configure.in, acinclude.m4, 
+ * the macros in the folders AC_CONFIG_MACRO_DIR and AC_CONFIG_MACRO_DIRS 
+ * name, and the Makefile.am of every Makefile in AC_CONFIG_FILES that 
+ * automake made a Makefile.in for. Only those files are looked at, the 
+ * source tree is not walked.
+ */
+static gboolean
+autoreconf_needed (const gchar *source_folder)
+{
+  gchar *configure_path;
+  gchar *configure_ac_path;
+  gchar *acinclude_path;
+  gchar *contents = NULL;
+  GPtrArray *arguments;
+  time_t mtime;
+  gboolean needed;
+  guint i;
+  
+  configure_path = g_build_filename (source_folder, "configure", NULL);
+  configure_ac_path = g_build_filename (source_folder, "configure.ac", NULL);
+  if (!g_file_test (configure_ac_path, G_FILE_TEST_EXISTS))
+    {
+      g_free (configure_ac_path);
+      configure_ac_path = g_build_filename (source_folder, "configure.in", NULL);
+    }
+  
+  if (!get_modified_time (configure_path, &mtime))
+    {
+      g_free (configure_ac_path);
+      g_free (configure_path);
+      return TRUE;
+    }
+  
+  acinclude_path = g_build_filename (source_folder, "acinclude.m4", NULL);
+  needed = is_newer (configure_ac_path, mtime) || is_newer (acinclude_path, mtime);
+  g_free (acinclude_path);
+  
+  if (!needed && g_file_get_contents (configure_ac_path, &contents, NULL, NULL))
+    {
+      arguments = g_ptr_array_new_with_free_func (g_free);
+      add_macro_arguments (contents, "AC_CONFIG_MACRO_DIR", arguments);
+      add_macro_arguments (contents, "AC_CONFIG_MACRO_DIRS", arguments);
+      
+      for (i = 0; !needed && i < arguments->len; i++)
+        {
+          gchar *folder_path;
+          folder_path = g_build_filename (source_folder, g_ptr_array_index (arguments, i), NULL);
+          needed = has_newer_macros (folder_path, mtime);
+          g_free (folder_path);
+        }
+      
+      g_ptr_array_set_size (arguments, 0);
+      add_macro_arguments (contents, "AC_CONFIG_FILES", arguments);
+      
+      for (i = 0; !needed && i < arguments->len; i++)
+        {
+          gchar *file = g_ptr_array_index (arguments, i);
+          gchar *makefile_path;
+          gchar *input_path;
+          
+          /* an output may name its input as in Makefile:Makefile.in */
+          if (strchr (file, ':') != NULL)
+            *strchr (file, ':') = '\0';
+          
+          makefile_path = g_build_filename (source_folder, file, NULL);
+          if (g_str_has_suffix (makefile_path, G_DIR_SEPARATOR_S "Makefile"))
+            {
+              input_path = g_strconcat (makefile_path, ".in", NULL);
+              if (g_file_test (input_path, G_FILE_TEST_EXISTS))
+                {
+                  g_free (input_path);
+                  input_path = g_strconcat (makefile_path, ".am", NULL);
+                  needed = is_newer (input_path, mtime);
+                }
+              g_free (input_path);
+            }
+          g_free (makefile_path);
+        }
+      
+      g_ptr_array_free (arguments, TRUE);
+    }
+  
+  g_free (contents);
+  g_free (configure_ac_path);
+  g_free (configure_path);
+  return needed;
+}
+
+static gboolean
+is_newer (const gchar *file_path,
+          time_t       mtime)
+{
+  time_t file_mtime;
+  return get_modified_time (file_path, &file_mtime) && file_mtime > mtime;
+}
+
+static gboolean
+has_newer_macros (const gchar *folder_path,
+                  time_t       mtime)
+{
+  GDir *dir;
+  const gchar *name;
+  gboolean newer = FALSE;
+  
+  dir = g_dir_open (folder_path, 0, NULL);
+  if (dir == NULL)
+    return FALSE;
+  
+  while (!newer && (name = g_dir_read_name (dir)) != NULL)
+    {
+      gchar *file_path;
+      
+      if (!g_str_has_suffix (name, ".m4"))
+        continue;
+      
+      file_path = g_build_filename (folder_path, name, NULL);
+      newer = is_newer (file_path, mtime);
+      g_free (file_path);
+    }
+    
+  g_dir_close (dir);
+  return newer;
+}
+
+/*
+ * Adds the words of the first argument of every call to the macro in 
+ * configure.ac, without the m4 quotes. Words that use shell variables 
+ * cannot be resolved here and are left out.
+ */
+static void
+add_macro_arguments (const gchar *contents,
+                     const gchar *macro,
+                     GPtrArray   *arguments)
+{
+  const gchar *p = contents;
+  gsize length = strlen (macro);
+  
+  while ((p = strstr (p, macro)) != NULL)
+    {
+      const gchar *start;
+      gchar *argument;
+      gchar **words;
+      gchar **word;
+      gint depth = 0;
+      
+      if ((p > contents && (g_ascii_isalnum (p[-1]) || p[-1] == '_')) || p[length] != '(')
+        {
+          p += length;
+          continue;
+        }
+      
+      start = p = p + length + 1;
+      for (; *p != '\0'; p++)
+        {
+          if (*p == '(')
+            depth++;
+          else if (*p == ')' && depth-- == 0)
+            break;
+          else if (*p == ',' && depth == 0)
+            break;
+        }
+      
+      argument = g_strndup (start, p - start);
+      g_strdelimit (argument, "[]", ' ');
+      words = g_strsplit_set (argument, " \t\r\n\\", -1);
+      for (word = words; *word != NULL; word++)
+        if (**word != '\0' && strchr (*word, '$') == NULL)
+          g_ptr_array_add (arguments, g_strdup (*word));
+      
+      g_strfreev (words);
+      g_free (argument);
+    }
+}
+
+static gboolean
+configure_needed (const gchar *configure_path,
+                  const gchar *build_folder,
+                  const gchar *stamp_path,
+                  const gchar *checksum)
+{
+  gchar *config_status_path;
+  time_t configure_mtime;
+  time_t config_status_mtime;
+  gchar *contents = NULL;
+  gboolean needed = TRUE;
+  
+  config_status_path = g_build_filename (build_folder, "config.status", NULL);
+  
+  if (get_modified_time (configure_path, &configure_mtime) &&
+      get_modified_time (config_status_path, &config_status_mtime) &&
+      config_status_mtime >= configure_mtime &&
+      g_file_get_contents (stamp_path, &contents, NULL, NULL))
+    needed = g_strcmp0 (g_strstrip (contents), checksum) != 0;
+  
+  g_free (contents);
+  g_free (config_status_path);
+  return needed;
+}
+
+static gchar*
+get_configure_cache_path (AutotoolsEngine  *engine,
+                          AutotoolsConfig  *config,
+                          gchar           **envp)
+{
+  AutotoolsEnginePrivate *priv;
+  gchar *folder_path;
+  gchar *file_name;
+  gchar *settings;
+  gchar *checksum;
+  gchar *file_path;
+  
+  priv = AUTOTOOLS_ENGINE_GET_PRIVATE (engine);
+
+  switch (autotools_config_get_configure_cache (config))
+    {
+    case AUTOTOOLS_CONFIGURE_CACHE_PROJECT:
+      folder_path = codeslayer_get_project_config_folder_path (priv->codeslayer, 
+                                                               autotools_config_get_project (config));
+      if (autotools_config_get_name (config) != NULL)
+        {
+          file_name = g_strconcat (autotools_config_get_name (config), "-", CONFIGURE_CACHE_FILE, NULL);
+          file_path = g_build_filename (folder_path, file_name, NULL);
+          g_free (file_name);
+        }
+      else
+        {
+          file_path = g_build_filename (folder_path, CONFIGURE_CACHE_FILE, NULL);
+        }
+      g_free (folder_path);
+      return file_path;
+    case AUTOTOOLS_CONFIGURE_CACHE_SHARED:
+      settings = get_toolchain_settings (config, envp);
+      checksum = g_compute_checksum_for_string (G_CHECKSUM_SHA1, settings, -1);
+      checksum[12] = '\0';
+      g_free (settings);
+      file_name = g_strconcat ("config-", checksum, ".cache", NULL);
+      file_path = g_build_filename (g_get_user_cache_dir (), "codeslayer", "autotools", file_name, NULL);
+      g_free (file_name);
+      g_free (checksum);
+      return file_path;
+    default:
+      return NULL;
+    }
+}
+
+static gchar*
+get_cache_file_option (AutotoolsEngine  *engine,
+                       AutotoolsConfig  *config,
+                       gchar           **envp)
+{
+  gchar *cache_path;
+  gchar *option;
+  
+  cache_path = get_configure_cache_path (engine, config, envp);
+  if (cache_path == NULL)
+    return NULL;
+  
+  option = g_strconcat ("--cache-file=", cache_path, NULL);
+  g_free (cache_path);
+  
+  return option;
+}
+
+/*
+ * The cache file only holds while the compilers it probed stay the same, 
+ * so a fingerprint of the toolchain is kept next to it and the cache is 
+ * thrown away as soon as the fingerprint changes. That includes turning 
+ * the launcher on or off, which changes CC and CXX and would otherwise 
+ * make configure refuse the cache. It is checked when the configure step 
+ * gets its job slot rather than when the command is queued, so a 
+ * configure that is already running on the same cache is not undercut 
+ * by a command that is only being put together.
+ */
+static void
+check_configure_cache (Build *build,
+                       Step  *step)
+{
+  AutotoolsConfig *config;
+  gchar *cache_folder;
+  gchar *fingerprint_path;
+  gchar *fingerprint;
+  gchar *contents = NULL;
+  
+  config = autotools_output_get_config (build->output);
+  
+  cache_folder = g_path_get_dirname (step->cache_path);
+  g_mkdir_with_parents (cache_folder, 0755);
+  
+  fingerprint_path = g_strconcat (step->cache_path, TOOLCHAIN_SUFFIX, NULL);
+  fingerprint = get_toolchain_fingerprint (config, build->command->envp);
+  
+  if (!g_file_get_contents (fingerprint_path, &contents, NULL, NULL) ||
+      g_strcmp0 (g_strstrip (contents), fingerprint) != 0)
+    {
+      g_remove (step->cache_path);
+      g_file_set_contents (fingerprint_path, fingerprint, -1, NULL);
+    }
+  
+  g_free (contents);
+  g_free (fingerprint);
+  g_free (fingerprint_path);
+  g_free (cache_folder);
+}
+
+/*
+ * Everything that decides what configure finds: the configure 
+ * parameters, the compiler launcher, which ends up in CC and CXX, and the 
+ * toolchain variables of the environment the command runs with. It keys 
+ * the shared cache so that projects with different settings never share 
+ * one.
+ */
+static gchar*
+get_toolchain_settings (AutotoolsConfig  *config,
+                        gchar           **envp)
+{
+  const gchar *variables[] = {"CC", "CXX", "CPP", "CFLAGS", "CXXFLAGS", 
+                              "CPPFLAGS", "LDFLAGS", "LIBS", "PATH", NULL};
+  const gchar *configure_parameters;
+  const gchar *compiler_launcher;
+  GString *string;
+  gint i;
+  
+  configure_parameters = autotools_config_get_configure_parameters (config);
+  compiler_launcher = autotools_config_get_compiler_launcher (config);
+  
+  string = g_string_new (NULL);
+  g_string_append_printf (string, "parameters=%s\nlauncher=%s\n", 
+                          configure_parameters != NULL ? configure_parameters : "",
+                          compiler_launcher != NULL ? compiler_launcher : "");
+  
+  for (i = 0; variables[i] != NULL; i++)
+    g_string_append_printf (string, "%s=%s\n", variables[i], 
+                            g_environ_getenv (envp, variables[i]) != NULL ? 
+                            g_environ_getenv (envp, variables[i]) : "");
+  
+  return g_string_free (string, FALSE);
+}
+
+/*
+ * The settings together with the compilers they resolve to, looked up 
+ * on the PATH of the command rather than the editor's, so that updating 
+ * a compiler in place is noticed as well.
+ */
+static gchar*
+get_toolchain_fingerprint (AutotoolsConfig  *config,
+                           gchar           **envp)
+{
+  const gchar *programs[] = {"cc", "gcc", "c++", "g++", "clang", "ld", NULL};
+  const gchar *variables[] = {"CC", "CXX", NULL};
+  GPtrArray *names;
+  GString *string;
+  gchar *settings;
+  gchar *fingerprint;
+  guint i;
+  
+  settings = get_toolchain_settings (config, envp);
+  string = g_string_new (settings);
+  g_free (settings);
+  
+  names = g_ptr_array_new_with_free_func (g_free);
+  for (i = 0; programs[i] != NULL; i++)
+    g_ptr_array_add (names, g_strdup (programs[i]));
+  for (i = 0; variables[i] != NULL; i++)
+    {
+      const gchar *value;
+      gchar **words;
+      value = g_environ_getenv (envp, variables[i]);
+      if (value != NULL && g_shell_parse_argv (value, NULL, &words, NULL))
+        {
+          g_ptr_array_add (names, g_strdup (words[0]));
+          g_strfreev (words);
+        }
+    }
+  
+  for (i = 0; i < names->len; i++)
+    {
+      gchar *program_path;
+      GStatBuf buf;
+      
+      program_path = find_program (g_ptr_array_index (names, i), envp);
+      if (program_path != NULL && g_stat (program_path, &buf) == 0)
+        g_string_append_printf (string, "%s %ld %ld\n", program_path, 
+                                (glong) buf.st_size, (glong) buf.st_mtime);
+      g_free (program_path);
+    }
+  
+  fingerprint = g_compute_checksum_for_string (G_CHECKSUM_SHA1, string->str, string->len);
+  g_string_free (string, TRUE);
+  g_ptr_array_free (names, TRUE);
+  
+  return fingerprint;
+}
+
+static gchar*
+find_program (const gchar  *program,
+              gchar       **envp)
+{
+  const gchar *path;
+  gchar **folders;
+  gchar **folder;
+  gchar *program_path = NULL;
+  
+  if (g_path_is_absolute (program))
+    return g_file_test (program, G_FILE_TEST_IS_EXECUTABLE) ? g_strdup (program) : NULL;
+  
+  path = g_environ_getenv (envp, "PATH");
+  if (path == NULL)
+    return NULL;
+  
+  folders = g_strsplit (path, G_SEARCHPATH_SEPARATOR_S, -1);
+  for (folder = folders; *folder != NULL && program_path == NULL; folder++)
+    {
+      gchar *file_path;
+      file_path = g_build_filename (**folder != '\0' ? *folder : ".", program, NULL);
+      if (g_file_test (file_path, G_FILE_TEST_IS_EXECUTABLE) && 
+          !g_file_test (file_path, G_FILE_TEST_IS_DIR))
+        program_path = file_path;
+      else
+        g_free (file_path);
+    }
+  g_strfreev (folders);
+  
+  return program_path;
+}
+
+static void
+project_clear_configure_cache_action (AutotoolsEngine *engine, 
+                                      GList           *selections)
+{
+  GList *list;
+  
+  for (list = selections; list != NULL; list = list->next)
+    {
+      CodeSlayerProjectsSelection *selection = list->data;
+      CodeSlayerProject *project;
+      GList *outputs;
+      GList *item;
+      
+      project = codeslayer_projects_selection_get_project (CODESLAYER_PROJECTS_SELECTION (selection));
+      outputs = get_outputs_by_project (engine, project);
+      
+      for (item = outputs; item != NULL; item = item->next)
+        {
+          AutotoolsConfig *config;
+          gchar **envp;
+          gchar *cache_path;
+          gchar *fingerprint_path;
+          
+          config = autotools_output_get_config (item->data);
+          envp = get_environment (config);
+          cache_path = get_configure_cache_path (engine, config, envp);
+          g_strfreev (envp);
+          if (cache_path == NULL)
+            continue;
+          
+          fingerprint_path = g_strconcat (cache_path, TOOLCHAIN_SUFFIX, NULL);
+          g_remove (cache_path);
+          g_remove (fingerprint_path);
+          autotools_output_append_text (item->data, "configure cache cleared\n", -1);
+          
+          g_free (fingerprint_path);
+          g_free (cache_path);
+        }
+      
+      g_list_free (outputs);
+    }
+}
+
+static GList*
+get_outputs_by_active_document (AutotoolsEngine *engine)
+{
+  AutotoolsEnginePrivate *priv;
+  CodeSlayer *codeslayer;
+  CodeSlayerProject *project;
+  
+  priv = AUTOTOOLS_ENGINE_GET_PRIVATE (engine);
+  codeslayer = priv->codeslayer;
+  
+  project = codeslayer_get_active_document_project (codeslayer);
+  if (project == NULL)
+    {
+      GtkWidget *dialog;
+      dialog =  gtk_message_dialog_new (NULL, 
+                                        GTK_DIALOG_MODAL,
+                                        GTK_MESSAGE_ERROR, GTK_BUTTONS_OK,
+                                        "There are no open documents. Not able to determine what project to execute command against.");
+      gtk_dialog_run (GTK_DIALOG (dialog));
+      gtk_widget_destroy (dialog);
+      return NULL;
+    }
+
+  return get_outputs_by_project (engine, project);
+}
+
+/*
+ * Returns the outputs of the active configurations of the project, in 
+ * the order they are listed in. The default configuration is called 
+ * "default" in that list, and is the only one built when the list is 
+ * empty or names no configuration that exists. A named configuration 
+ * without a build_folder of its own builds in the one from [main], so 
+ * a configuration whose build folder is already taken by an earlier 
+ * one in the list is left out, two builds must never share a folder.
+ */
+static GList*
+get_outputs_by_project (AutotoolsEngine   *engine, 
+                        CodeSlayerProject *project)
+{
+  AutotoolsConfig *config;
+  gchar **active_configurations;
+  GHashTable *build_folders;
+  GList *outputs = NULL;
+  
+  config = get_config_by_project (engine, project);
+  
+  if (config == NULL)
+    {
+      GtkWidget *dialog;
+      gchar *msg;
+      msg = g_strconcat ("There is no config for project ", 
+                         codeslayer_project_get_name (project), ".", NULL);      
+      dialog =  gtk_message_dialog_new (NULL, 
+                                        GTK_DIALOG_MODAL,
+                                        GTK_MESSAGE_ERROR, GTK_BUTTONS_OK,
+                                        msg, 
+                                        NULL);
+      gtk_dialog_run (GTK_DIALOG (dialog));
+      gtk_widget_destroy (dialog);
+      g_free (msg);
+      return NULL;
+    }
+  
+  build_folders = g_hash_table_new_full (g_str_hash, g_str_equal, g_free, NULL);
+  
+  active_configurations = autotools_config_get_active_configurations (config);
+  for (; active_configurations != NULL && *active_configurations != NULL; active_configurations++)
+    {
+      AutotoolsConfig *configuration;
+      AutotoolsConfig *owner;
+      AutotoolsOutput *output;
+      gchar *build_folder;
+      
+      if (g_strcmp0 (*active_configurations, DEFAULT_CONFIGURATION) == 0)
+        configuration = config;
+      else
+        configuration = autotools_config_get_configuration (config, *active_configurations);
+      
+      if (configuration == NULL)
+        continue;
+      
+      output = get_output_by_config (engine, configuration);
+      
+      build_folder = get_real_path (autotools_config_get_build_folder (configuration));
+      if (build_folder != NULL)
+        {
+          owner = g_hash_table_lookup (build_folders, build_folder);
+          if (owner != NULL && owner != configuration)
+            {
+              gchar *label;
+              gchar *text;
+              label = get_config_label (owner);
+              text = g_strdup_printf ("not built, %s already builds in %s\n", label, build_folder);
+              autotools_output_append_text (output, text, -1);
+              g_free (text);
+              g_free (label);
+              g_free (build_folder);
+              continue;
+            }
+          g_hash_table_insert (build_folders, build_folder, configuration);
+        }
+      
+      if (g_list_find (outputs, output) == NULL)
+        outputs = g_list_append (outputs, output);
+    }
+  
+  g_hash_table_destroy (build_folders);
+  
+  if (outputs == NULL)
+    outputs = g_list_append (outputs, get_output_by_config (engine, config));
+
+  return outputs;
+}
+
+static AutotoolsOutput*
+get_output_by_config (AutotoolsEngine *engine, 
+                      AutotoolsConfig *config)
+{
+  AutotoolsEnginePrivate *priv;
+  GtkWidget *output;
+  
+  priv = AUTOTOOLS_ENGINE_GET_PRIVATE (engine);
+  
+  output = autotools_notebook_get_output_by_config (AUTOTOOLS_NOTEBOOK (priv->notebook), 
+                                                    config);
+  if (output == NULL)
+    {
+      gchar *label;
+      label = get_config_label (config);
+      output = autotools_output_new (config, priv->codeslayer);
+      g_signal_connect (G_OBJECT (output), "diagnostics",
+                        G_CALLBACK (output_diagnostics_action), engine);
+      g_signal_connect_object (G_OBJECT (output), "destroy",
+                               G_CALLBACK (output_destroyed_action), engine, 0);
+      autotools_notebook_add_output (AUTOTOOLS_NOTEBOOK (priv->notebook), output, label);
+      g_free (label);
+    }                                                           
+
+  return AUTOTOOLS_OUTPUT (output);
+}
+
+/*
+ * The project name, followed by the configuration name for the named 
+ * configurations. Used for the tabs and to tell builds apart in batches.
+ */
+static gchar*
+get_config_label (AutotoolsConfig *config)
+{
+  const gchar *project_name;
+  project_name = codeslayer_project_get_name (autotools_config_get_project (config));
+  if (autotools_config_get_name (config) == NULL)
+    return g_strdup (project_name);
+  return g_strdup_printf ("%s [%s]", project_name, autotools_config_get_name (config));
+}
+
+/*
+ * The path with symbolic links and relative parts resolved, so that two 
+ * spellings of the same folder compare equal. A folder that does not 
+ * exist yet is only stripped of trailing separators.
+ */
+static gchar*
+get_real_path (const gchar *path)
+{
+  gchar *real_path;
+  gchar *result;
+  gsize length;
+  
+  if (path == NULL || *path == '\0')
+    return NULL;
+  
+  real_path = realpath (path, NULL);
+  if (real_path != NULL)
+    {
+      result = g_strdup (real_path);
+      free (real_path);
+      return result;
+    }
+  
+  result = g_strdup (path);
+  length = strlen (result);
+  while (length > 1 && G_IS_DIR_SEPARATOR (result[length - 1]))
+    result[--length] = '\0';
+  return result;
+}
+
+static Command*
+new_command (AutotoolsConfig *config,
+             const gchar     *finished_text)
+{
+  Command *command;
+  command = g_malloc (sizeof (Command));
+  command->steps = NULL;
+  command->envp = get_environment (config);
+  command->finished_text = g_strdup (finished_text);
+  command->tasks = NULL;
+  command->interactive = TRUE;
+  return command;
+}
+
+/*
+ * Adds a step that runs argv in the working directory, the step takes 
+ * over argv. A step without argv only shows its text.
+ */
+static Step*
+add_step (Command      *command,
+          const gchar  *working_directory,
+          gchar       **argv,
+          const gchar  *text)
+{
+  Step *step;
+  step = g_malloc (sizeof (Step));
+  step->working_directory = g_strdup (working_directory);
+  step->argv = argv;
+  step->text = g_strdup (text);
+  step->stamp_path = NULL;
+  step->stamp = NULL;
+  step->cache_path = NULL;
+  command->steps = g_list_append (command->steps, step);
+  return step;
+}
+
+static gchar*
+get_command_text (Command *command)
+{
+  GString *text;
+  GList *list;
+  
+  text = g_string_new (NULL);
+  
+  for (list = command->steps; list != NULL; list = list->next)
+    {
+      Step *step = list->data;
+      gchar *arguments;
+      
+      if (step->argv == NULL)
+        continue;
+      
+      if (text->len > 0)
+        g_string_append (text, " && ");
+      
+      arguments = g_strjoinv (" ", step->argv);
+      g_string_append (text, arguments);
+      g_free (arguments);
+    }
+  
+  return g_string_free (text, FALSE);
+}
+
+/*
+ * Tasks still waiting on a command that is thrown away without running, 
+ * because the build was stopped before its turn, are cancelled.
+ */
+static void
+destroy_command (Command *command)
+{
+  GList *list;
+  
+  for (list = command->tasks; list != NULL; list = list->next)
+    {
+      g_task_return_new_error (list->data, G_IO_ERROR, G_IO_ERROR_CANCELLED, 
+                               "The build was stopped before it started");
+      g_object_unref (list->data);
+    }
+  g_list_free (command->tasks);
+  
+  g_list_free_full (command->steps, (GDestroyNotify) destroy_step);
+  g_strfreev (command->envp);
+  g_free (command->finished_text);
+  g_free (command);
+}
+
+static void
+destroy_step (Step *step)
+{
+  g_free (step->working_directory);
+  g_strfreev (step->argv);
+  g_free (step->text);
+  g_free (step->stamp_path);
+  g_free (step->stamp);
+  g_free (step->cache_path);
+  g_free (step);
+}
+
+/*
+ * The environment of the editor with the project's variables laid over 
+ * it in the order they were given. A value can refer to the variables 
+ * set so far, so PATH=/opt/bin:$PATH puts a folder in front of the path.
+ */
+static gchar**
+get_environment (AutotoolsConfig *config)
+{
+  gchar **envp;
+  gchar **environment;
+  
+  envp = g_get_environ ();
+  
+  environment = autotools_config_get_environment (config);
+  for (; environment != NULL && *environment != NULL; environment++)
+    {
+      gchar **pair;
+      pair = g_strsplit (*environment, "=", 2);
+      if (pair[0] != NULL && pair[1] != NULL)
+        {
+          gchar *value;
+          value = expand_variables (pair[1], envp);
+          envp = g_environ_setenv (envp, pair[0], value, TRUE);
+          g_free (value);
+        }
+      g_strfreev (pair);
+    }
+  
+  if (autotools_config_get_profile_targets (config))
+    {
+      gchar *log_path;
+      log_path = g_build_filename (autotools_config_get_build_folder (config), 
+                                   AUTOTOOLS_TIMING_LOG, NULL);
+      envp = g_environ_setenv (envp, "AUTOTOOLS_TIMING_LOG", log_path, TRUE);
+      g_free (log_path);
+    }
+  
+  return envp;
+}
+
+/*
+ * Replaces $NAME and ${NAME} with the value of the variable in envp, or 
+ * nothing when it is not set. Anything else is taken literally.
+ */
+static gchar*
+expand_variables (const gchar  *value,
+                  gchar       **envp)
+{
+  GString *result;
+  const gchar *p;
+  
+  result = g_string_new (NULL);
+  
+  for (p = value; *p != '\0'; p++)
+    {
+      const gchar *start;
+      const gchar *end;
+      const gchar *last;
+      gchar *name;
+      
+      if (*p != '$')
+        {
+          g_string_append_c (result, *p);
+          continue;
+        }
+      
+      if (p[1] == '{')
+        {
+          start = p + 2;
+          end = strchr (start, '}');
+          last = end;
+        }
+      else
+        {
+          start = p + 1;
+          for (end = start; g_ascii_isalnum (*end) || *end == '_'; end++);
+          last = end - 1;
+        }
+      
+      if (end == NULL || end == start)
+        {
+          g_string_append_c (result, *p);
+          continue;
+        }
+      
+      name = g_strndup (start, end - start);
+      if (g_environ_getenv (envp, name) != NULL)
+        g_string_append (result, g_environ_getenv (envp, name));
+      g_free (name);
+      
+      p = last;
+    }
+  
+  return g_string_free (result, FALSE);
+}
+
+/*
+ * There is only ever one command running per output. Asking for another
+ * one while it runs makes it the single pending command, so a newer
+ * request replaces an older one. Depending on the config the running
+ * command is either left to finish first or stopped straight away.
+ */
+static void
+run_command (AutotoolsEngine *engine,
+             AutotoolsOutput *output,
+             Batch           *batch,
+             Command         *command)
+{
+  AutotoolsEnginePrivate *priv;
+  AutotoolsConfig *config;
+  Build *build;
+
+  priv = AUTOTOOLS_ENGINE_GET_PRIVATE (engine);
+
+  config = autotools_output_get_config (output);
+
+  build = g_hash_table_lookup (priv->builds, output);
+  if (build == NULL)
+    {
+      build = g_malloc (sizeof (Build));
+      build->engine = engine;
+      build->output = output;
+      build->process = NULL;
+      build->command = command;
+      build->stopped = FALSE;
+      build->succeeded = FALSE;
+      build->slots = MIN (get_jobs (config), priv->max_slots);
+      build->batches = NULL;
+      build->has_launcher_stats = FALSE;
+      build->pending_command = NULL;
+      g_hash_table_insert (priv->builds, output, build);
+
+      autotools_output_clear_text (output);
+      g_queue_push_tail (priv->waiting, build);
+    }
+  else if (build->process == NULL)
+    {
+      command->tasks = g_list_concat (build->command->tasks, command->tasks);
+      command->interactive = command->interactive || build->command->interactive;
+      build->command->tasks = NULL;
+      destroy_command (build->command);
+      build->command = command;
+    }
+  else
+    {
+      if (build->pending_command != NULL)
+        {
+          command->tasks = g_list_concat (build->pending_command->tasks, command->tasks);
+          command->interactive = command->interactive || build->pending_command->interactive;
+          build->pending_command->tasks = NULL;
+          destroy_command (build->pending_command);
+        }
+      build->pending_command = command;
+
+      if (autotools_config_get_duplicate_build (config) == AUTOTOOLS_DUPLICATE_BUILD_RESTART)
+        {
+          build->stopped = TRUE;
+          autotools_process_stop (build->process);
+        }
+      else
+        {
+          autotools_output_append_text (output, "queued\n", -1);
+        }
+    }
+
+  if (batch != NULL && g_list_find (build->batches, batch) == NULL)
+    build->batches = g_list_prepend (build->batches, batch);
+
+  schedule_builds (engine);
+
+  if (build->process == NULL && g_queue_find (priv->waiting, build) != NULL)
+    autotools_output_append_text (output, "waiting for a free job slot\n", -1);
+}
+
+/*
+ * Each build is charged the number of jobs it runs make with, and builds
+ * are only started while the total fits the number of processors. A build
+ * always starts when nothing else is running so that a project configured
+ * with more jobs than there are processors cannot stall the queue.
+ */
+static void
+schedule_builds (AutotoolsEngine *engine)
+{
+  AutotoolsEnginePrivate *priv;
+  Build *build;
+
+  priv = AUTOTOOLS_ENGINE_GET_PRIVATE (engine);
+
+  while ((build = g_queue_peek_head (priv->waiting)) != NULL)
+    {
+      if (priv->running_slots > 0 &&
+          priv->running_slots + build->slots > priv->max_slots)
+        break;
+
+      g_queue_pop_head (priv->waiting);
+      start_build (build);
+    }
+}
+
+static void
+start_build (Build *build)
+{
+  AutotoolsEnginePrivate *priv;
+  gchar *text;
+
+  priv = AUTOTOOLS_ENGINE_GET_PRIVATE (build->engine);
+
+  autotools_output_clear_text (build->output);
+
+  build->stopped = FALSE;
+  build->has_launcher_stats = FALSE;
+  g_hash_table_remove (priv->launcher_reads, build->output);
+  if (get_compiler_launcher (build) != NULL && *get_compiler_launcher (build) != '\0')
+    {
+      GCancellable *cancellable;
+      cancellable = g_cancellable_new ();
+      g_hash_table_insert (priv->launcher_reads, build->output, cancellable);
+      autotools_launcher_read_stats_async (get_compiler_launcher (build), build->command->envp, 
+                                           cancellable, 
+                                           (GAsyncReadyCallback) launcher_stats_started_action, 
+                                           build);
+    }
+  memset (&build->usage, 0, sizeof (AutotoolsProcessUsage));
+  build->errors = 0;
+  build->warnings = 0;
+  remove_timing_log (build);
+  
+  priv->running_slots += build->slots;
+  
+  text = get_command_text (build->command);
+  g_signal_emit_by_name ((gpointer) build->engine, "build-started", 
+                         autotools_config_get_project (autotools_output_get_config (build->output)), 
+                         text);
+  g_free (text);
+
+  if (!start_step (build))
+    finish_build (build, -1);
+}
+
+/*
+ * Starts the first step of the command that has something to run, 
+ * showing the text of the steps on the way. The program is executed 
+ * directly with the environment of the command, no shell is involved.
+ */
+static gboolean
+start_step (Build *build)
+{
+  GError *error = NULL;
+  Step *step;
+
+  while (build->command->steps != NULL)
+    {
+      step = build->command->steps->data;
+      if (step->text != NULL)
+        autotools_output_append_text (build->output, step->text, -1);
+      if (step->argv != NULL)
+        break;
+      destroy_step (step);
+      build->command->steps = g_list_delete_link (build->command->steps, 
+                                                  build->command->steps);
+    }
+  
+  if (build->command->steps == NULL)
+    return FALSE;
+  
+  if (step->stamp_path != NULL)
+    g_remove (step->stamp_path);
+  
+  if (step->cache_path != NULL)
+    check_configure_cache (build, step);
+
+  build->process = autotools_process_new ();
+
+  g_signal_connect_swapped (G_OBJECT (build->process), "output",
+                            G_CALLBACK (process_output_action), build->output);
+  g_signal_connect (G_OBJECT (build->process), "finished",
+                    G_CALLBACK (process_finished_action), build);
+
+  if (!autotools_process_start (build->process, step->working_directory, 
+                                step->argv, build->command->envp, &error))
+    {
+      autotools_output_append_text (build->output, error->message, -1);
+      autotools_output_append_text (build->output, "\n", -1);
+      g_error_free (error);
+      release_process (build);
+      return FALSE;
+    }
+    
+  return TRUE;
+}
+
+/*
+ * Called once the current step succeeded. Writes its stamp and moves on, 
+ * returning whether there is another step to run.
+ */
+static gboolean
+next_step (Build *build)
+{
+  Step *step;
+  
+  step = build->command->steps->data;
+  if (step->stamp_path != NULL)
+    g_file_set_contents (step->stamp_path, step->stamp, -1, NULL);
+  
+  destroy_step (step);
+  build->command->steps = g_list_delete_link (build->command->steps, 
+                                              build->command->steps);
+  
+  return build->command->steps != NULL;
+}
+
+static const gchar*
+get_compiler_launcher (Build *build)
+{
+  AutotoolsConfig *config;
+  config = autotools_output_get_config (build->output);
+  return autotools_config_get_compiler_launcher (config);
+}
+
+static gchar*
+get_timing_log_path (Build *build)
+{
+  AutotoolsConfig *config;
+  config = autotools_output_get_config (build->output);
+  if (!autotools_config_get_profile_targets (config))
+    return NULL;
+  return g_build_filename (autotools_config_get_build_folder (config), 
+                           AUTOTOOLS_TIMING_LOG, NULL);
+}
+
+/*
+ * Comparing the CPU time with the wall time shows how well the jobs kept 
+ * the processors busy, while the block counts and the peak resident size 
+ * point at builds that are waiting on the disk or short of memory.
+ */
+static gchar*
+get_usage_text (const AutotoolsProcessUsage *usage)
+{
+  gchar *status;
+  gchar *text;
+  
+  if (usage->status < 0)
+    status = g_strdup ("unknown exit status");
+  else if (WIFSIGNALED (usage->status))
+    status = g_strdup_printf ("killed by signal %d", WTERMSIG (usage->status));
+  else
+    status = g_strdup_printf ("exit status %d", WEXITSTATUS (usage->status));
+  
+  text = g_strdup_printf ("%s, %.1fs wall, %.1fs user, %.1fs sys, %ld MB peak, "
+                          "%ld blocks in, %ld blocks out\n", status, 
+                          usage->wall_time, usage->user_time, usage->system_time, 
+                          usage->max_rss / 1024, usage->in_blocks, usage->out_blocks);
+  g_free (status);
+  return text;
+}
+
+static void
+remove_timing_log (Build *build)
+{
+  gchar *log_path;
+  log_path = get_timing_log_path (build);
+  if (log_path != NULL)
+    {
+      g_remove (log_path);
+      g_free (log_path);
+    }
+}
+
+static void
+process_output_action (AutotoolsOutput *output,
+                       const gchar     *text)
+{
+  autotools_output_append_text (output, text, -1);
+}
+
+static void
+process_finished_action (AutotoolsProcess *process,
+                         gint              status,
+                         Build            *build)
+{
+  add_usage (&build->usage, autotools_process_get_usage (process));
+  release_process (build);
+  
+  if (!build->stopped && status == 0 && next_step (build))
+    {
+      if (start_step (build))
+        return;
+      status = -1;
+    }
+  
+  finish_build (build, status);
+}
+
+/*
+ * The launcher counters are read without blocking, once when the build 
+ * starts and again when it is finished. Both reads of an output share a 
+ * cancellable, so an answer that comes back after the output started 
+ * another build or was closed is dropped without touching either.
+ */
+static void
+launcher_stats_started_action (GObject      *source,
+                               GAsyncResult *result,
+                               Build        *build)
+{
+  AutotoolsLauncherStats stats;
+  
+  if (!autotools_launcher_read_stats_finish (result, &stats, NULL))
+    return;
+  
+  build->launcher_stats = stats;
+  build->has_launcher_stats = TRUE;
+}
+
+static void
+launcher_stats_finished_action (GObject      *source,
+                                GAsyncResult *result,
+                                LauncherRead *read)
+{
+  AutotoolsLauncherStats stats;
+  
+  if (autotools_launcher_read_stats_finish (result, &stats, NULL))
+    {
+      gchar *text;
+      text = autotools_launcher_format_stats (read->launcher, &read->stats, &stats);
+      autotools_output_append_text (read->output, text, -1);
+      g_free (text);
+    }
+  
+  g_free (read->launcher);
+  g_free (read);
+}
+
+static void
+cancel_launcher_read (GCancellable *cancellable)
+{
+  g_cancellable_cancel (cancellable);
+  g_object_unref (cancellable);
+}
+
+static void
+add_usage (AutotoolsProcessUsage       *total,
+           const AutotoolsProcessUsage *usage)
+{
+  total->status = usage->status;
+  total->wall_time += usage->wall_time;
+  total->user_time += usage->user_time;
+  total->system_time += usage->system_time;
+  total->max_rss = MAX (total->max_rss, usage->max_rss);
+  total->in_blocks += usage->in_blocks;
+  total->out_blocks += usage->out_blocks;
+}
+
+static void
+finish_build (Build *build,
+              gint   status)
+{
+  AutotoolsEnginePrivate *priv;
+  AutotoolsEngine *engine;
+  AutotoolsBuildResult *result;
+  gchar *log_path;
+
+  engine = build->engine;
+  priv = AUTOTOOLS_ENGINE_GET_PRIVATE (engine);
+
+  autotools_output_create_links (build->output);
+
+  if (build->stopped)
+    autotools_output_append_text (build->output, "stopped\n", -1);
+  else if (build->command->finished_text != NULL)
+    autotools_output_append_text (build->output, build->command->finished_text, -1);
+  
+  if (build->has_launcher_stats)
+    {
+      LauncherRead *read;
+      read = g_malloc (sizeof (LauncherRead));
+      read->output = build->output;
+      read->launcher = g_strdup (get_compiler_launcher (build));
+      read->stats = build->launcher_stats;
+      autotools_launcher_read_stats_async (read->launcher, build->command->envp, 
+                                           g_hash_table_lookup (priv->launcher_reads, build->output), 
+                                           (GAsyncReadyCallback) launcher_stats_finished_action, 
+                                           read);
+    }
+  else
+    {
+      g_hash_table_remove (priv->launcher_reads, build->output);
+    }
+    
+  log_path = get_timing_log_path (build);
+  if (log_path != NULL)
+    {
+      gchar *report;
+      report = autotools_timing_get_report (log_path, SLOWEST_TARGETS);
+      if (report != NULL)
+        {
+          autotools_output_append_text (build->output, report, -1);
+          g_free (report);
+        }
+      g_free (log_path);
+    }
+  
+  if (!build->stopped && status >= 0)
+    {
+      gchar *text;
+      text = get_usage_text (&build->usage);
+      autotools_output_append_text (build->output, text, -1);
+      g_free (text);
+      
+      text = get_command_text (build->command);
+      autotools_output_add_run (build->output, text, &build->usage);
+      g_free (text);
+    }
+
+  build->succeeded = !build->stopped && status == 0;
+  priv->running_slots -= build->slots;
+  
+  result = new_build_result (build, status);
+  g_signal_emit_by_name ((gpointer) engine, "build-finished", result->project, result);
+  return_tasks (build->command, result);
+  autotools_build_result_free (result);
+
+  if (build->pending_command == NULL)
+    {
+      remove_build (build);
+    }
+  else
+    {
+      destroy_command (build->command);
+      build->command = build->pending_command;
+      build->pending_command = NULL;
+      g_queue_push_head (priv->waiting, build);
+    }
+
+  schedule_builds (engine);
+}
+
+static void
+remove_build (Build *build)
+{
+  AutotoolsEnginePrivate *priv;
+  AutotoolsOutput *output;
+  GList *batches;
+  GList *list;
+  gboolean succeeded;
+
+  priv = AUTOTOOLS_ENGINE_GET_PRIVATE (build->engine);
+
+  output = build->output;
+  batches = build->batches;
+  succeeded = build->succeeded;
+  build->batches = NULL;
+
+  g_hash_table_remove (priv->builds, output);
+
+  for (list = batches; list != NULL; list = list->next)
+    finish_batch (list->data, output, succeeded);
+  g_list_free (batches);
+}
+
+static Batch*
+new_batch (AutotoolsEngine *engine,
+           ExecuteFunc      execute,
+           GList           *outputs)
+{
+  AutotoolsEnginePrivate *priv;
+  Batch *batch;
+  GHashTable *names;
+  GList *list;
+
+  priv = AUTOTOOLS_ENGINE_GET_PRIVATE (engine);
+
+  batch = g_malloc (sizeof (Batch));
+  batch->engine = engine;
+  batch->execute = execute;
+  batch->timer = g_timer_new ();
+  batch->nodes = g_hash_table_new_full (g_direct_hash, g_direct_equal, NULL, g_free);
+  batch->total = 0;
+  batch->remaining = 0;
+  priv->batches = g_list_prepend (priv->batches, batch);
+
+  names = g_hash_table_new (g_str_hash, g_str_equal);
+
+  for (list = outputs; list != NULL; list = list->next)
+    {
+      AutotoolsConfig *config;
+      BatchNode *node;
+
+      config = autotools_output_get_config (list->data);
+
+      node = g_malloc (sizeof (BatchNode));
+      node->output = list->data;
+      node->name = get_config_label (config);
+      node->blockers = 0;
+      node->unresolved = 0;
+      node->dependents = NULL;
+      node->finished = FALSE;
+
+      g_hash_table_insert (batch->nodes, node->output, node);
+      g_hash_table_insert (names, (gpointer) node->name, node);
+      batch->total++;
+    }
+
+  for (list = outputs; list != NULL; list = list->next)
+    {
+      AutotoolsConfig *config;
+      BatchNode *node;
+      gchar **depends_on;
+
+      node = g_hash_table_lookup (batch->nodes, list->data);
+      config = autotools_output_get_config (node->output);
+      depends_on = autotools_config_get_depends_on (config);
+
+      for (; depends_on != NULL && *depends_on != NULL; depends_on++)
+        {
+          BatchNode *dependency = NULL;
+          if (autotools_config_get_name (config) != NULL)
+            {
+              gchar *name;
+              name = g_strdup_printf ("%s [%s]", *depends_on, autotools_config_get_name (config));
+              dependency = g_hash_table_lookup (names, name);
+              g_free (name);
+            }
+          if (dependency == NULL)
+            dependency = g_hash_table_lookup (names, *depends_on);
+          add_batch_dependency (dependency, node);
+        }
+    }
+
+  if (execute == execute_full_build)
+    add_source_dependencies (batch, outputs);
+
+  g_hash_table_destroy (names);
+
+  batch->remaining = batch->total;
+  return batch;
+}
+
+static void
+add_batch_dependency (BatchNode *dependency,
+                      BatchNode *node)
+{
+  if (dependency == NULL || dependency == node ||
+      g_list_find (dependency->dependents, node) != NULL)
+    return;
+  dependency->dependents = g_list_prepend (dependency->dependents, node);
+  node->blockers++;
+}
+
+/*
+ * The configurations of a project share its source folder. When that 
+ * folder needs autoreconf the first configuration runs it, and the 
+ * others wait for it so that autoreconf is not run on the same files 
+ * twice at once. By the time they start it is up to date and they go 
+ * straight to configure. When it does not need autoreconf they all start 
+ * together.
+ */
+static void
+add_source_dependencies (Batch *batch,
+                         GList *outputs)
+{
+  GHashTable *sources;
+  GList *list;
+
+  sources = g_hash_table_new_full (g_str_hash, g_str_equal, g_free, NULL);
+
+  for (list = outputs; list != NULL; list = list->next)
+    {
+      AutotoolsConfig *config;
+      BatchNode *node;
+      BatchNode *first;
+      gchar *source_folder;
+
+      node = g_hash_table_lookup (batch->nodes, list->data);
+      config = autotools_output_get_config (node->output);
+      source_folder = g_path_get_dirname (autotools_config_get_configure_file (config));
+
+      first = g_hash_table_lookup (sources, source_folder);
+      if (first == NULL)
+        {
+          g_hash_table_insert (sources, source_folder, node);
+          continue;
+        }
+
+      if (autoreconf_needed (source_folder))
+        add_batch_dependency (first, node);
+      g_free (source_folder);
+    }
+
+  g_hash_table_destroy (sources);
+}
+
+/*
+ * The dependencies are sorted up front so that a cycle is reported 
+ * straight away instead of leaving those projects waiting forever. Only 
+ * projects without unfinished dependencies are handed to the job queue, 
+ * the rest are started as their dependencies succeed.
+ */
+static void
+start_batch (Batch *batch,
+             GList *outputs)
+{
+  GQueue *ready;
+  GList *list;
+  BatchNode *node;
+
+  batch->remaining++;
+
+  ready = g_queue_new ();
+  for (list = outputs; list != NULL; list = list->next)
+    {
+      node = g_hash_table_lookup (batch->nodes, list->data);
+      node->unresolved = node->blockers;
+      if (node->unresolved == 0)
+        g_queue_push_tail (ready, node);
+    }
+
+  while ((node = g_queue_pop_head (ready)) != NULL)
+    {
+      for (list = node->dependents; list != NULL; list = list->next)
+        {
+          BatchNode *dependent = list->data;
+          if (--dependent->unresolved == 0)
+            g_queue_push_tail (ready, dependent);
+        }
+    }
+  g_queue_free (ready);
+
+  for (list = outputs; list != NULL; list = list->next)
+    {
+      node = g_hash_table_lookup (batch->nodes, list->data);
+      if (node->unresolved > 0)
+        cancel_batch_node (batch, node, "cancelled, dependency cycle\n");
+    }
+
+  for (list = outputs; list != NULL; list = list->next)
+    {
+      node = g_hash_table_lookup (batch->nodes, list->data);
+      if (node->finished)
+        continue;
+
+      if (node->blockers == 0)
+        {
+          batch->execute (batch->engine, node->output, batch);
+        }
+      else
+        {
+          autotools_output_clear_text (node->output);
+          autotools_output_append_text (node->output, "waiting for dependencies\n", -1);
+        }
+    }
+
+  release_batch (batch, NULL);
+}
+
+static void
+finish_batch (Batch           *batch,
+              AutotoolsOutput *output,
+              gboolean         succeeded)
+{
+  BatchNode *node;
+  gchar *text = NULL;
+  GList *list;
+
+  node = g_hash_table_lookup (batch->nodes, output);
+  if (node == NULL || node->finished)
+    return;
+
+  node->finished = TRUE;
+
+  if (!succeeded)
+    text = g_strdup_printf ("cancelled, %s failed\n", node->name);
+
+  for (list = node->dependents; list != NULL; list = list->next)
+    {
+      BatchNode *dependent = list->data;
+      if (dependent->finished)
+        continue;
+      if (!succeeded)
+        cancel_batch_node (batch, dependent, text);
+      else if (--dependent->blockers == 0)
+        batch->execute (batch->engine, dependent->output, batch);
+    }
+
+  g_free (text);
+  release_batch (batch, output);
+}
+
+static void
+cancel_batch_node (Batch       *batch,
+                   BatchNode   *node,
+                   const gchar *text)
+{
+  GList *list;
+
+  if (node->finished)
+    return;
+
+  node->finished = TRUE;
+  autotools_output_clear_text (node->output);
+  autotools_output_append_text (node->output, text, -1);
+
+  for (list = node->dependents; list != NULL; list = list->next)
+    cancel_batch_node (batch, list->data, text);
+
+  release_batch (batch, node->output);
+}
+
+static void
+release_batch (Batch           *batch,
+               AutotoolsOutput *output)
+{
+  AutotoolsEnginePrivate *priv;
+
+  if (--batch->remaining > 0)
+    return;
+
+  if (output != NULL)
+    {
+      gchar *text;
+      text = g_strdup_printf ("%d builds finished in %.1f seconds\n", batch->total,
+                              g_timer_elapsed (batch->timer, NULL));
+      autotools_output_append_text (output, text, -1);
+      g_free (text);
+    }
+
+  priv = AUTOTOOLS_ENGINE_GET_PRIVATE (batch->engine);
+  priv->batches = g_list_remove (priv->batches, batch);
+  destroy_batch (batch);
+}
+
+static void
+destroy_batch (Batch *batch)
+{
+  GHashTableIter iter;
+  BatchNode *node;
+
+  g_hash_table_iter_init (&iter, batch->nodes);
+  while (g_hash_table_iter_next (&iter, NULL, (gpointer) &node))
+    {
+      g_list_free (node->dependents);
+      g_free (node->name);
+    }
+
+  g_hash_table_destroy (batch->nodes);
+  g_timer_destroy (batch->timer);
+  g_free (batch);
+}
+
+static void
+release_process (Build *build)
+{
+  if (build->process == NULL)
+    return;
+  g_signal_handlers_disconnect_by_func (build->process, process_output_action, build->output);
+  g_signal_handlers_disconnect_by_func (build->process, process_finished_action, build);
+  g_object_unref (build->process);
+  build->process = NULL;
+}
+
+static void
+destroy_build (Build *build)
+{
+  g_list_free (build->batches);
+  release_process (build);
+  destroy_command (build->command);
+  if (build->pending_command != NULL)
+    destroy_command (build->pending_command);
+  g_free (build);
+}
+
+static AutotoolsBuildResult*
+new_build_result (Build *build,
+                  gint   status)
+{
+  AutotoolsBuildResult *result;
+  
+  result = g_malloc (sizeof (AutotoolsBuildResult));
+  result->project = autotools_config_get_project (autotools_output_get_config (build->output));
+  result->succeeded = build->succeeded;
+  result->stopped = build->stopped;
+  result->exit_status = status >= 0 && WIFEXITED (status) ? WEXITSTATUS (status) : -1;
+  result->errors = build->errors;
+  result->warnings = build->warnings;
+  result->usage = build->usage;
+  
+  return result;
+}
+
+/*
+ * Every task that asked for the command gets its own copy of the result, 
+ * unless it was cancelled in the meantime.
+ */
+static void
+return_tasks (Command              *command,
+              AutotoolsBuildResult *result)
+{
+  GList *list;
+  
+  for (list = command->tasks; list != NULL; list = list->next)
+    {
+      GTask *task = list->data;
+      if (!g_task_return_error_if_cancelled (task))
+        g_task_return_pointer (task, autotools_build_result_copy (result), 
+                               (GDestroyNotify) autotools_build_result_free);
+      g_object_unref (task);
+    }
+  
+  g_list_free (command->tasks);
+  command->tasks = NULL;
+}
+
+static void
+output_diagnostics_action (AutotoolsOutput *output,
+                           guint            first,
+                           guint            last,
+                           AutotoolsEngine *engine)
+{
+  AutotoolsEnginePrivate *priv;
+  AutotoolsDiagnostics *diagnostics;
+  GPtrArray *batch;
+  Build *build;
+  guint i;
+  
+  priv = AUTOTOOLS_ENGINE_GET_PRIVATE (engine);
+  
+  build = g_hash_table_lookup (priv->builds, output);
+  diagnostics = autotools_output_get_diagnostics (output);
+  batch = g_ptr_array_new_with_free_func ((GDestroyNotify) free_build_diagnostic);
+  
+  for (i = first; i < last; i++)
+    {
+      AutotoolsDiagnostic *diagnostic;
+      AutotoolsBuildDiagnostic *build_diagnostic;
+      
+      diagnostic = autotools_diagnostics_get (diagnostics, i);
+      
+      build_diagnostic = g_malloc (sizeof (AutotoolsBuildDiagnostic));
+      build_diagnostic->file_path = g_strdup (autotools_output_get_file (output, diagnostic->file_id));
+      build_diagnostic->line = diagnostic->line;
+      build_diagnostic->column = diagnostic->column;
+      build_diagnostic->severity = diagnostic->severity;
+      g_ptr_array_add (batch, build_diagnostic);
+      
+      if (build != NULL && diagnostic->severity == AUTOTOOLS_DIAGNOSTIC_ERROR)
+        build->errors++;
+      else if (build != NULL && diagnostic->severity == AUTOTOOLS_DIAGNOSTIC_WARNING)
+        build->warnings++;
+    }
+  
+  g_signal_emit_by_name ((gpointer) engine, "diagnostics-batch", 
+                         autotools_config_get_project (autotools_output_get_config (output)), 
+                         batch);
+  
+  g_ptr_array_free (batch, TRUE);
+}
+
+/*
+ * The cancellable can be cancelled from any thread, so the request is 
+ * only dropped once the context the task was started in gets to it.
+ */
+static void
+run_cancelled_action (GCancellable *cancellable,
+                      GTask        *task)
+{
+  GSource *source;
+  
+  source = g_idle_source_new ();
+  g_source_set_callback (source, (GSourceFunc) run_cancelled_idle, 
+                         g_object_ref (task), g_object_unref);
+  g_source_attach (source, g_task_get_context (task));
+  g_source_unref (source);
+}
+
+/*
+ * The cancelled request gets its error straight away and the command 
+ * carries on for everybody else. The command is only stopped, or thrown 
+ * away when it is the pending one, when the request was the last thing 
+ * waiting for it: no other task, no batch and no build from the menus.
+ */
+static gboolean
+run_cancelled_idle (GTask *task)
+{
+  AutotoolsEnginePrivate *priv;
+  AutotoolsEngine *engine;
+  GtkWidget *output;
+  Command *command = NULL;
+  Build *build = NULL;
+  Run *run;
+  
+  engine = g_task_get_source_object (task);
+  priv = AUTOTOOLS_ENGINE_GET_PRIVATE (engine);
+  run = g_task_get_task_data (task);
+  
+  output = autotools_notebook_get_output_by_config (AUTOTOOLS_NOTEBOOK (priv->notebook), 
+                                                    run->config);
+  if (output != NULL)
+    build = g_hash_table_lookup (priv->builds, output);
+  if (build == NULL)
+    return G_SOURCE_REMOVE;
+  
+  if (g_list_find (build->command->tasks, task) != NULL)
+    command = build->command;
+  else if (build->pending_command != NULL && 
+           g_list_find (build->pending_command->tasks, task) != NULL)
+    command = build->pending_command;
+  if (command == NULL)
+    return G_SOURCE_REMOVE;
+  
+  command->tasks = g_list_remove (command->tasks, task);
+  g_task_return_error_if_cancelled (task);
+  g_object_unref (task);
+  
+  if (command->tasks != NULL || command->interactive || build->batches != NULL)
+    return G_SOURCE_REMOVE;
+  
+  if (command == build->pending_command)
+    {
+      destroy_command (command);
+      build->pending_command = NULL;
+    }
+  else if (build->pending_command != NULL)
+    {
+      build->stopped = TRUE;
+      autotools_process_stop (build->process);
+    }
+  else
+    {
+      output_stop_action (engine, AUTOTOOLS_OUTPUT (output));
+    }
+  
+  return G_SOURCE_REMOVE;
+}
+
+static void
+destroy_run (Run *run)
+{
+  if (run->cancellable != NULL)
+    {
+      g_cancellable_disconnect (run->cancellable, run->cancelled_id);
+      g_object_unref (run->cancellable);
+    }
+  g_object_unref (run->config);
+  g_free (run);
+}
+
+static void
+free_build_diagnostic (AutotoolsBuildDiagnostic *diagnostic)
+{
+  g_free (diagnostic->file_path);
+  g_free (diagnostic);
 }
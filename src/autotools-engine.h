@@ -21,6 +21,8 @@
 
 #include <gtk/gtk.h>
 #include <codeslayer/codeslayer.h>
+#include "autotools-diagnostics.h"
+#include "autotools-process.h"
 
 G_BEGIN_DECLS
 
@@ -30,6 +32,8 @@ G_BEGIN_DECLS
 #define IS_AUTOTOOLS_ENGINE(obj)         (G_TYPE_CHECK_INSTANCE_TYPE ((obj), AUTOTOOLS_ENGINE_TYPE))
 #define IS_AUTOTOOLS_ENGINE_CLASS(klass) (G_TYPE_CHECK_CLASS_TYPE ((klass), AUTOTOOLS_ENGINE_TYPE))
 
+#define AUTOTOOLS_BUILD_RESULT_TYPE      (autotools_build_result_get_type ())
+
 typedef struct _AutotoolsEngine AutotoolsEngine;
 typedef struct _AutotoolsEngineClass AutotoolsEngineClass;
 
@@ -41,9 +45,33 @@ struct _AutotoolsEngine
 struct _AutotoolsEngineClass
 {
   GObjectClass parent_class;
+
+  void (*build_started) (AutotoolsEngine *engine);
+  void (*diagnostics_batch) (AutotoolsEngine *engine);
+  void (*build_finished) (AutotoolsEngine *engine);
 };
 
+typedef struct
+{
+  CodeSlayerProject     *project;
+  gboolean               succeeded;
+  gboolean               stopped;
+  gint                   exit_status;
+  guint                  errors;
+  guint                  warnings;
+  AutotoolsProcessUsage  usage;
+} AutotoolsBuildResult;
+
+typedef struct
+{
+  gchar                       *file_path;
+  guint                        line;
+  guint                        column;
+  AutotoolsDiagnosticSeverity  severity;
+} AutotoolsBuildDiagnostic;
+
 GType autotools_engine_get_type (void) G_GNUC_CONST;
+GType autotools_build_result_get_type (void) G_GNUC_CONST;
 
 AutotoolsEngine*  autotools_engine_new (CodeSlayer *codeslayer,
                                         GtkWidget  *menu,
@@ -53,6 +81,19 @@ AutotoolsEngine*  autotools_engine_new (CodeSlayer *codeslayer,
                                         
 void autotools_engine_load_configs (AutotoolsEngine *engine);
 
+void                   autotools_engine_run_async   (AutotoolsEngine       *engine,
+                                                     CodeSlayerProject     *project,
+                                                     const gchar           *target,
+                                                     GCancellable          *cancellable,
+                                                     GAsyncReadyCallback    callback,
+                                                     gpointer               user_data);
+AutotoolsBuildResult*  autotools_engine_run_finish  (AutotoolsEngine       *engine,
+                                                     GAsyncResult          *result,
+                                                     GError               **error);
+
+AutotoolsBuildResult*  autotools_build_result_copy  (AutotoolsBuildResult  *result);
+void                   autotools_build_result_free  (AutotoolsBuildResult  *result);
+
 G_END_DECLS
 
 #endif /* _AUTOTOOLS_ENGINE_H */
@@ -0,0 +1,282 @@
+/*
+ * Copyright (C) 2010 - Jeff Johnston
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+ */
+
+#include <string.h>
+#include <sys/wait.h>
+#include "autotools-launcher.h"
+#include "autotools-process.h"
+
+static void stats_output_action    (AutotoolsProcess       *process,
+                                    const gchar            *text,
+                                    GTask                  *task);
+static void stats_finished_action  (AutotoolsProcess       *process,
+                                    gint                    status,
+                                    GTask                  *task);
+static void free_output            (GString                *output);
+static gboolean parse_stats        (const gchar            *text,
+                                    AutotoolsLauncherStats *stats);
+
+/*
+ * A compiler launcher such as ccache wraps the compiler that configure 
+ * would otherwise pick. It is put in front of CC and CXX when configure 
+ * runs, and the generated makefiles carry it from there. A compiler 
+ * chosen in the configure arguments is wrapped where it stands, 
+ * otherwise the one from the environment, or the default, is added as a 
+ * new argument. Nothing changes when there is no launcher.
+ */
+void
+autotools_launcher_wrap_configure_arguments (const gchar  *launcher,
+                                             GPtrArray    *arguments,
+                                             gchar       **envp)
+{
+  const gchar *variables[] = {"CC", "CXX", NULL};
+  const gchar *defaults[] = {"cc", "c++", NULL};
+  gint i;
+  
+  if (launcher == NULL || *launcher == '\0')
+    return;
+  
+  for (i = 0; variables[i] != NULL; i++)
+    {
+      const gchar *compiler;
+      gchar *prefix;
+      gboolean wrapped = FALSE;
+      guint j;
+      
+      prefix = g_strconcat (variables[i], "=", NULL);
+      
+      for (j = 0; j < arguments->len; j++)
+        {
+          gchar *argument = g_ptr_array_index (arguments, j);
+          if (!g_str_has_prefix (argument, prefix))
+            continue;
+          compiler = argument + strlen (prefix);
+          g_ptr_array_index (arguments, j) = g_strdup_printf ("%s%s %s", prefix, launcher, 
+                                                               *compiler != '\0' ? compiler : defaults[i]);
+          g_free (argument);
+          wrapped = TRUE;
+        }
+      
+      if (!wrapped)
+        {
+          compiler = g_environ_getenv (envp, variables[i]);
+          g_ptr_array_add (arguments, g_strdup_printf ("%s%s %s", prefix, launcher, 
+                                                       compiler != NULL && *compiler != '\0' ? 
+                                                       compiler : defaults[i]));
+        }
+      
+      g_free (prefix);
+    }
+}
+
+/*
+ * Runs the launcher with --print-stats in the environment of the build, 
+ * so that a PATH or CCACHE_DIR set for the project picks the same 
+ * launcher and cache the compilers use. The counters are read from the 
+ * output as it arrives, without blocking the main loop.
+ */
+void
+autotools_launcher_read_stats_async (const gchar          *launcher,
+                                     gchar               **envp,
+                                     GCancellable         *cancellable,
+                                     GAsyncReadyCallback   callback,
+                                     gpointer              user_data)
+{
+  AutotoolsProcess *process;
+  gchar **launcher_argv = NULL;
+  gchar *argv[3];
+  GError *error = NULL;
+  GTask *task;
+  
+  task = g_task_new (NULL, cancellable, callback, user_data);
+  g_task_set_source_tag (task, autotools_launcher_read_stats_async);
+  
+  if (launcher == NULL || *launcher == '\0')
+    {
+      g_task_return_new_error (task, G_IO_ERROR, G_IO_ERROR_INVALID_ARGUMENT, 
+                               "There is no compiler launcher.");
+      g_object_unref (task);
+      return;
+    }
+  
+  if (!g_shell_parse_argv (launcher, NULL, &launcher_argv, &error))
+    {
+      g_task_return_error (task, error);
+      g_object_unref (task);
+      return;
+    }
+  
+  argv[0] = launcher_argv[0];
+  argv[1] = "--print-stats";
+  argv[2] = NULL;
+  
+  g_task_set_task_data (task, g_string_new (NULL), (GDestroyNotify) free_output);
+  
+  process = autotools_process_new ();
+  g_signal_connect (G_OBJECT (process), "output", 
+                    G_CALLBACK (stats_output_action), task);
+  g_signal_connect (G_OBJECT (process), "finished", 
+                    G_CALLBACK (stats_finished_action), task);
+  
+  if (!autotools_process_start (process, NULL, argv, envp, &error))
+    {
+      g_task_return_error (task, error);
+      g_object_unref (task);
+    }
+  
+  g_object_unref (process);
+  g_strfreev (launcher_argv);
+}
+
+gboolean
+autotools_launcher_read_stats_finish (GAsyncResult            *result,
+                                      AutotoolsLauncherStats  *stats,
+                                      GError                 **error)
+{
+  AutotoolsLauncherStats *value;
+  
+  g_return_val_if_fail (g_task_is_valid (result, NULL), FALSE);
+  
+  value = g_task_propagate_pointer (G_TASK (result), error);
+  if (value == NULL)
+    return FALSE;
+  
+  *stats = *value;
+  g_free (value);
+  return TRUE;
+}
+
+static void
+stats_output_action (AutotoolsProcess *process,
+                     const gchar      *text,
+                     GTask            *task)
+{
+  g_string_append (g_task_get_task_data (task), text);
+}
+
+static void
+stats_finished_action (AutotoolsProcess *process,
+                       gint              status,
+                       GTask            *task)
+{
+  AutotoolsLauncherStats *stats;
+  GString *output;
+  
+  output = g_task_get_task_data (task);
+  stats = g_malloc (sizeof (AutotoolsLauncherStats));
+  
+  if (status >= 0 && WIFEXITED (status) && WEXITSTATUS (status) == 0 &&
+      parse_stats (output->str, stats))
+    {
+      g_task_return_pointer (task, stats, g_free);
+    }
+  else
+    {
+      g_free (stats);
+      g_task_return_new_error (task, G_IO_ERROR, G_IO_ERROR_FAILED, 
+                               "The compiler launcher printed no statistics.");
+    }
+  
+  g_object_unref (task);
+}
+
+static void
+free_output (GString *output)
+{
+  g_string_free (output, TRUE);
+}
+
+/*
+ * Reads the counters that the launcher prints with --print-stats, one 
+ * "name<tab>value" pair per line. Both the ccache 3 and ccache 4 names 
+ * are understood. Any other launcher that prints the same format works 
+ * as well. Error output is mixed in and simply does not match.
+ */
+static gboolean
+parse_stats (const gchar            *text,
+             AutotoolsLauncherStats *stats)
+{
+  gchar **lines;
+  gchar **line;
+  gboolean result = FALSE;
+  
+  stats->hits = 0;
+  stats->misses = 0;
+  stats->size = 0;
+  
+  lines = g_strsplit (text, "\n", -1);
+  for (line = lines; *line != NULL; line++)
+    {
+      gchar *tab;
+      gint64 value;
+      
+      tab = strchr (*line, '\t');
+      if (tab == NULL)
+        continue;
+      
+      *tab = '\0';
+      value = g_ascii_strtoll (tab + 1, NULL, 10);
+      
+      if (g_strcmp0 (*line, "direct_cache_hit") == 0 ||
+          g_strcmp0 (*line, "preprocessed_cache_hit") == 0 ||
+          g_strcmp0 (*line, "cache_hit_direct") == 0 ||
+          g_strcmp0 (*line, "cache_hit_preprocessed") == 0)
+        stats->hits += value;
+      else if (g_strcmp0 (*line, "cache_miss") == 0)
+        stats->misses += value;
+      else if (g_strcmp0 (*line, "cache_size_kibibyte") == 0)
+        stats->size = value * 1024;
+      else
+        continue;
+        
+      result = TRUE;
+    }
+  
+  g_strfreev (lines);
+  return result;
+}
+
+/*
+ * The launcher does not count the bytes a hit saved, so the summary 
+ * reports how much the cache grew or shrank during the build instead.
+ */
+gchar*
+autotools_launcher_format_stats (const gchar            *launcher,
+                                 AutotoolsLauncherStats *before,
+                                 AutotoolsLauncherStats *after)
+{
+  gint64 hits;
+  gint64 misses;
+  gint64 size;
+  gchar *size_text;
+  gchar *text;
+  
+  hits = after->hits - before->hits;
+  misses = after->misses - before->misses;
+  size = after->size - before->size;
+  
+  size_text = g_format_size (ABS (size));
+  
+  text = g_strdup_printf ("%s: %" G_GINT64_FORMAT " hits, %" G_GINT64_FORMAT " misses (%.0f%%), cache size changed by %s%s\n",
+                          launcher, hits, misses, 
+                          hits + misses > 0 ? 100.0 * hits / (hits + misses) : 0.0,
+                          size < 0 ? "-" : "+", size_text);
+  
+  g_free (size_text);
+  return text;
+}
@@ -0,0 +1,50 @@
+/*
+ * Copyright (C) 2010 - Jeff Johnston
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+ */
+
+#ifndef __AUTOTOOLS_LAUNCHER_H__
+#define	__AUTOTOOLS_LAUNCHER_H__
+
+#include <gio/gio.h>
+
+G_BEGIN_DECLS
+
+typedef struct
+{
+  gint64 hits;
+  gint64 misses;
+  gint64 size;
+} AutotoolsLauncherStats;
+
+void      autotools_launcher_wrap_configure_arguments (const gchar           *launcher,
+                                                       GPtrArray             *arguments,
+                                                       gchar                **envp);
+void      autotools_launcher_read_stats_async         (const gchar            *launcher,
+                                                       gchar                 **envp,
+                                                       GCancellable           *cancellable,
+                                                       GAsyncReadyCallback     callback,
+                                                       gpointer                user_data);
+gboolean  autotools_launcher_read_stats_finish        (GAsyncResult           *result,
+                                                       AutotoolsLauncherStats *stats,
+                                                       GError                **error);
+gchar*    autotools_launcher_format_stats             (const gchar            *launcher,
+                                                       AutotoolsLauncherStats *before,
+                                                       AutotoolsLauncherStats *after);
+
+G_END_DECLS
+
+#endif /* __AUTOTOOLS_LAUNCHER_H__ */
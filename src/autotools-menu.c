@@ -30,12 +30,18 @@ static void add_menu_items             (AutotoolsMenu      *menu,
 static void make_action                (AutotoolsMenu      *menu);
 static void make_clean_action          (AutotoolsMenu      *menu);
 static void make_install_action        (AutotoolsMenu      *menu);
+static void make_directory_action      (AutotoolsMenu      *menu);
+static void compile_file_action        (AutotoolsMenu      *menu);
+static void stop_action                (AutotoolsMenu      *menu);
                                         
 enum
 {
   MAKE,
   MAKE_INSTALL,
   MAKE_CLEAN,
+  MAKE_DIRECTORY,
+  COMPILE_FILE,
+  STOP,
   LAST_SIGNAL
 };
 
@@ -70,6 +76,30 @@ autotools_menu_class_init (AutotoolsMenuClass *klass)
                   NULL, NULL, 
                   g_cclosure_marshal_VOID__VOID, G_TYPE_NONE, 0);
 
+  autotools_menu_signals[MAKE_DIRECTORY] =
+    g_signal_new ("make-directory", 
+                  G_TYPE_FROM_CLASS (klass),
+                  G_SIGNAL_RUN_LAST | G_SIGNAL_NO_RECURSE | G_SIGNAL_NO_HOOKS,
+                  G_STRUCT_OFFSET (AutotoolsMenuClass, make_directory),
+                  NULL, NULL, 
+                  g_cclosure_marshal_VOID__VOID, G_TYPE_NONE, 0);
+
+  autotools_menu_signals[COMPILE_FILE] =
+    g_signal_new ("compile-file", 
+                  G_TYPE_FROM_CLASS (klass),
+                  G_SIGNAL_RUN_LAST | G_SIGNAL_NO_RECURSE | G_SIGNAL_NO_HOOKS,
+                  G_STRUCT_OFFSET (AutotoolsMenuClass, compile_file),
+                  NULL, NULL, 
+                  g_cclosure_marshal_VOID__VOID, G_TYPE_NONE, 0);
+
+  autotools_menu_signals[STOP] =
+    g_signal_new ("stop", 
+                  G_TYPE_FROM_CLASS (klass),
+                  G_SIGNAL_RUN_LAST | G_SIGNAL_NO_RECURSE | G_SIGNAL_NO_HOOKS,
+                  G_STRUCT_OFFSET (AutotoolsMenuClass, stop),
+                  NULL, NULL, 
+                  g_cclosure_marshal_VOID__VOID, G_TYPE_NONE, 0);
+
   G_OBJECT_CLASS (klass)->finalize = (GObjectFinalizeFunc) autotools_menu_finalize;
 }
 
@@ -109,6 +139,10 @@ add_menu_items (AutotoolsMenu *menu,
   GtkWidget *make_item;
   GtkWidget *make_clean_item;
   GtkWidget *make_install_item;
+  GtkWidget *make_directory_item;
+  GtkWidget *compile_file_item;
+  GtkWidget *separator;
+  GtkWidget *stop_item;
 
   make_item = codeslayer_menu_item_new_with_label ("Make");
   gtk_widget_add_accelerator (make_item, "activate", 
@@ -126,6 +160,22 @@ add_menu_items (AutotoolsMenu *menu,
                               GTK_ACCEL_VISIBLE);  
   gtk_menu_shell_append (GTK_MENU_SHELL (submenu), make_clean_item);
   
+  make_directory_item = codeslayer_menu_item_new_with_label ("Make Directory");
+  gtk_widget_add_accelerator (make_directory_item, "activate", 
+                              accel_group, GDK_KEY_F9, GDK_SHIFT_MASK, GTK_ACCEL_VISIBLE);  
+  gtk_menu_shell_append (GTK_MENU_SHELL (submenu), make_directory_item);
+  
+  compile_file_item = codeslayer_menu_item_new_with_label ("Compile File");
+  gtk_widget_add_accelerator (compile_file_item, "activate", 
+                              accel_group, GDK_KEY_F9, GDK_MOD1_MASK, GTK_ACCEL_VISIBLE);  
+  gtk_menu_shell_append (GTK_MENU_SHELL (submenu), compile_file_item);
+  
+  separator = gtk_separator_menu_item_new ();
+  gtk_menu_shell_append (GTK_MENU_SHELL (submenu), separator);
+
+  stop_item = codeslayer_menu_item_new_with_label ("Stop");
+  gtk_menu_shell_append (GTK_MENU_SHELL (submenu), stop_item);
+  
   g_signal_connect_swapped (G_OBJECT (make_item), "activate", 
                             G_CALLBACK (make_action), menu);
    
@@ -134,6 +184,15 @@ add_menu_items (AutotoolsMenu *menu,
    
   g_signal_connect_swapped (G_OBJECT (make_install_item), "activate", 
                             G_CALLBACK (make_install_action), menu);
+   
+  g_signal_connect_swapped (G_OBJECT (make_directory_item), "activate", 
+                            G_CALLBACK (make_directory_action), menu);
+   
+  g_signal_connect_swapped (G_OBJECT (compile_file_item), "activate", 
+                            G_CALLBACK (compile_file_action), menu);
+   
+  g_signal_connect_swapped (G_OBJECT (stop_item), "activate", 
+                            G_CALLBACK (stop_action), menu);
 }
 
 static void 
@@ -153,3 +212,21 @@ make_install_action (AutotoolsMenu *menu)
 {
   g_signal_emit_by_name ((gpointer) menu, "make-install");
 }
+
+static void 
+make_directory_action (AutotoolsMenu *menu) 
+{
+  g_signal_emit_by_name ((gpointer) menu, "make-directory");
+}
+
+static void 
+compile_file_action (AutotoolsMenu *menu) 
+{
+  g_signal_emit_by_name ((gpointer) menu, "compile-file");
+}
+
+static void 
+stop_action (AutotoolsMenu *menu) 
+{
+  g_signal_emit_by_name ((gpointer) menu, "stop");
+}
@@ -44,6 +44,9 @@ struct _AutotoolsMenuClass
   void (*make) (AutotoolsMenu *menu);
   void (*make_install) (AutotoolsMenu *menu);
   void (*make_clean) (AutotoolsMenu *menu);
+  void (*make_directory) (AutotoolsMenu *menu);
+  void (*compile_file) (AutotoolsMenu *menu);
+  void (*stop) (AutotoolsMenu *menu);
 };
 
 GType autotools_menu_get_type (void) G_GNUC_CONST;
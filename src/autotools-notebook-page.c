@@ -17,6 +17,7 @@
  */
 
 #include "autotools-notebook-page.h"
+#include "autotools-output.h"
 
 static void autotools_notebook_page_class_init    (AutotoolsNotebookPageClass *klass);
 static void autotools_notebook_page_init          (AutotoolsNotebookPage      *notebook_page);
@@ -27,6 +28,8 @@ static void add_output                            (AutotoolsNotebookPage      *n
 static void add_buttons                           (AutotoolsNotebookPage      *notebook_page, 
                                                    GtkWidget                  *output);
 static void clear_action                          (GtkWidget *output);
+static void stop_action                           (AutotoolsNotebookPage      *notebook_page);
+static void export_trace_action                   (AutotoolsNotebookPage      *notebook_page);
 
 #define AUTOTOOLS_NOTEBOOK_PAGE_GET_PRIVATE(obj) \
   (G_TYPE_INSTANCE_GET_PRIVATE ((obj), AUTOTOOLS_NOTEBOOK_PAGE_TYPE, AutotoolsNotebookPagePrivate))
@@ -38,12 +41,38 @@ struct _AutotoolsNotebookPagePrivate
   GtkWidget *output;
 };
 
+enum
+{
+  STOP,
+  EXPORT_TRACE,
+  LAST_SIGNAL
+};
+
+static guint autotools_notebook_page_signals[LAST_SIGNAL] = { 0 };
+
 G_DEFINE_TYPE (AutotoolsNotebookPage, autotools_notebook_page, GTK_TYPE_HBOX)
 
 static void
 autotools_notebook_page_class_init (AutotoolsNotebookPageClass *klass)
 {
   GObjectClass *gobject_class = G_OBJECT_CLASS (klass);
+
+  autotools_notebook_page_signals[STOP] =
+    g_signal_new ("stop", 
+                  G_TYPE_FROM_CLASS (klass),
+                  G_SIGNAL_RUN_LAST | G_SIGNAL_NO_RECURSE | G_SIGNAL_NO_HOOKS,
+                  G_STRUCT_OFFSET (AutotoolsNotebookPageClass, stop),
+                  NULL, NULL, 
+                  g_cclosure_marshal_VOID__VOID, G_TYPE_NONE, 0);
+
+  autotools_notebook_page_signals[EXPORT_TRACE] =
+    g_signal_new ("export-trace", 
+                  G_TYPE_FROM_CLASS (klass),
+                  G_SIGNAL_RUN_LAST | G_SIGNAL_NO_RECURSE | G_SIGNAL_NO_HOOKS,
+                  G_STRUCT_OFFSET (AutotoolsNotebookPageClass, export_trace),
+                  NULL, NULL, 
+                  g_cclosure_marshal_VOID__VOID, G_TYPE_NONE, 0);
+
   gobject_class->finalize = (GObjectFinalizeFunc) autotools_notebook_page_finalize;
   g_type_class_add_private (klass, sizeof (AutotoolsNotebookPagePrivate));
 }
@@ -80,6 +109,10 @@ add_buttons (AutotoolsNotebookPage *notebook_page,
   GtkWidget *grid;
   GtkWidget *clear_button;
   GtkWidget *clear_image;
+  GtkWidget *stop_button;
+  GtkWidget *stop_image;
+  GtkWidget *export_trace_button;
+  GtkWidget *export_trace_image;
   
   grid = gtk_grid_new ();
   gtk_grid_set_row_spacing (GTK_GRID (grid), 2);
@@ -95,10 +128,38 @@ add_buttons (AutotoolsNotebookPage *notebook_page,
   
   gtk_grid_attach (GTK_GRID (grid), clear_button, 0, 0, 1, 1);
 
+  stop_button = gtk_button_new ();
+  gtk_widget_set_tooltip_text (stop_button, "Stop");
+
+  gtk_button_set_relief (GTK_BUTTON (stop_button), GTK_RELIEF_NONE);
+  gtk_button_set_focus_on_click (GTK_BUTTON (stop_button), FALSE);
+  stop_image = gtk_image_new_from_stock (GTK_STOCK_STOP, GTK_ICON_SIZE_MENU);
+  gtk_container_add (GTK_CONTAINER (stop_button), stop_image);
+  gtk_widget_set_can_focus (stop_button, FALSE);
+  
+  gtk_grid_attach (GTK_GRID (grid), stop_button, 0, 1, 1, 1);
+
+  export_trace_button = gtk_button_new ();
+  gtk_widget_set_tooltip_text (export_trace_button, "Export Trace");
+
+  gtk_button_set_relief (GTK_BUTTON (export_trace_button), GTK_RELIEF_NONE);
+  gtk_button_set_focus_on_click (GTK_BUTTON (export_trace_button), FALSE);
+  export_trace_image = gtk_image_new_from_stock (GTK_STOCK_SAVE, GTK_ICON_SIZE_MENU);
+  gtk_container_add (GTK_CONTAINER (export_trace_button), export_trace_image);
+  gtk_widget_set_can_focus (export_trace_button, FALSE);
+  
+  gtk_grid_attach (GTK_GRID (grid), export_trace_button, 0, 2, 1, 1);
+
   gtk_box_pack_start (GTK_BOX (notebook_page), grid, FALSE, FALSE, 2);
   
   g_signal_connect_swapped (G_OBJECT (clear_button), "clicked",
                             G_CALLBACK (clear_action), output);
+  
+  g_signal_connect_swapped (G_OBJECT (stop_button), "clicked",
+                            G_CALLBACK (stop_action), notebook_page);
+  
+  g_signal_connect_swapped (G_OBJECT (export_trace_button), "clicked",
+                            G_CALLBACK (export_trace_action), notebook_page);
 }
 
 static void 
@@ -118,9 +179,19 @@ add_output (AutotoolsNotebookPage *notebook_page,
 static void
 clear_action (GtkWidget *output)
 {
-  GtkTextBuffer *buffer;
-  buffer = gtk_text_view_get_buffer (GTK_TEXT_VIEW (output));
-  gtk_text_buffer_set_text (buffer, "", -1);
+  autotools_output_clear_text (AUTOTOOLS_OUTPUT (output));
+}
+
+static void
+stop_action (AutotoolsNotebookPage *notebook_page)
+{
+  g_signal_emit_by_name ((gpointer) notebook_page, "stop");
+}
+
+static void
+export_trace_action (AutotoolsNotebookPage *notebook_page)
+{
+  g_signal_emit_by_name ((gpointer) notebook_page, "export-trace");
 }
 
 GtkWidget*
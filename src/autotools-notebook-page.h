@@ -41,6 +41,9 @@ struct _AutotoolsNotebookPage
 struct _AutotoolsNotebookPageClass
 {
   GtkHBoxClass parent_class;
+
+  void (*stop) (AutotoolsNotebookPage *notebook_page);
+  void (*export_trace) (AutotoolsNotebookPage *notebook_page);
 };
 
 GType autotools_notebook_page_get_type (void) G_GNUC_CONST;
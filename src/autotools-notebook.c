@@ -27,6 +27,14 @@ static void autotools_notebook_finalize    (AutotoolsNotebook      *notebook);
 
 static void close_action                   (AutotoolsNotebookTab   *notebook_tab,
                                             AutotoolsNotebook      *notebook);
+static void stop_action                    (AutotoolsNotebookPage  *notebook_page,
+                                            AutotoolsNotebook      *notebook);
+static void export_trace_action            (AutotoolsNotebookPage  *notebook_page,
+                                            AutotoolsNotebook      *notebook);
+static void page_removed_action            (AutotoolsNotebook      *notebook,
+                                            GtkWidget              *notebook_page,
+                                            guint                   page_num);
+static void update_page_nums               (AutotoolsNotebook      *notebook);
 
 #define AUTOTOOLS_NOTEBOOK_GET_PRIVATE(obj) \
   (G_TYPE_INSTANCE_GET_PRIVATE ((obj), AUTOTOOLS_NOTEBOOK_TYPE, AutotoolsNotebookPrivate))
@@ -35,14 +43,48 @@ typedef struct _AutotoolsNotebookPrivate AutotoolsNotebookPrivate;
 
 struct _AutotoolsNotebookPrivate
 {
-  gchar *foo;
+  GHashTable *configs;
+  GHashTable *outputs;
+};
+
+typedef struct
+{
+  AutotoolsConfig   *config;
+  GtkWidget         *notebook_page;
+  GtkWidget         *output;
+  gint               page_num;
+} Entry;
+
+enum
+{
+  STOP,
+  EXPORT_TRACE,
+  LAST_SIGNAL
 };
 
+static guint autotools_notebook_signals[LAST_SIGNAL] = { 0 };
+
 G_DEFINE_TYPE (AutotoolsNotebook, autotools_notebook, GTK_TYPE_NOTEBOOK)
 
 static void
 autotools_notebook_class_init (AutotoolsNotebookClass *klass)
 {
+  autotools_notebook_signals[STOP] =
+    g_signal_new ("stop", 
+                  G_TYPE_FROM_CLASS (klass),
+                  G_SIGNAL_RUN_LAST | G_SIGNAL_NO_RECURSE | G_SIGNAL_NO_HOOKS,
+                  G_STRUCT_OFFSET (AutotoolsNotebookClass, stop),
+                  NULL, NULL, 
+                  g_cclosure_marshal_VOID__OBJECT, G_TYPE_NONE, 1, GTK_TYPE_WIDGET);
+
+  autotools_notebook_signals[EXPORT_TRACE] =
+    g_signal_new ("export-trace", 
+                  G_TYPE_FROM_CLASS (klass),
+                  G_SIGNAL_RUN_LAST | G_SIGNAL_NO_RECURSE | G_SIGNAL_NO_HOOKS,
+                  G_STRUCT_OFFSET (AutotoolsNotebookClass, export_trace),
+                  NULL, NULL, 
+                  g_cclosure_marshal_VOID__OBJECT, G_TYPE_NONE, 1, GTK_TYPE_WIDGET);
+
   G_OBJECT_CLASS (klass)->finalize = (GObjectFinalizeFunc) autotools_notebook_finalize;
   g_type_class_add_private (klass, sizeof (AutotoolsNotebookPrivate));
 }
@@ -50,12 +92,28 @@ autotools_notebook_class_init (AutotoolsNotebookClass *klass)
 static void
 autotools_notebook_init (AutotoolsNotebook *notebook)
 {
+  AutotoolsNotebookPrivate *priv;
+  priv = AUTOTOOLS_NOTEBOOK_GET_PRIVATE (notebook);
+  priv->configs = g_hash_table_new_full (g_direct_hash, g_direct_equal, NULL, g_free);
+  priv->outputs = g_hash_table_new (g_direct_hash, g_direct_equal);
+
   gtk_notebook_set_scrollable (GTK_NOTEBOOK (notebook), TRUE);
+
+  g_signal_connect (G_OBJECT (notebook), "page-added",
+                    G_CALLBACK (update_page_nums), NULL);
+  g_signal_connect (G_OBJECT (notebook), "page-removed",
+                    G_CALLBACK (page_removed_action), NULL);
+  g_signal_connect (G_OBJECT (notebook), "page-reordered",
+                    G_CALLBACK (update_page_nums), NULL);
 }
 
 static void
 autotools_notebook_finalize (AutotoolsNotebook *notebook)
 {
+  AutotoolsNotebookPrivate *priv;
+  priv = AUTOTOOLS_NOTEBOOK_GET_PRIVATE (notebook);
+  g_hash_table_destroy (priv->outputs);
+  g_hash_table_destroy (priv->configs);
   G_OBJECT_CLASS (autotools_notebook_parent_class)->finalize (G_OBJECT (notebook));
 }
 
@@ -72,8 +130,12 @@ autotools_notebook_add_output (AutotoolsNotebook *notebook,
                                GtkWidget         *output,
                                const gchar       *label)
 {
+  AutotoolsNotebookPrivate *priv;
   GtkWidget *notebook_page;
   GtkWidget *notebook_tab;
+  Entry *entry;
+  
+  priv = AUTOTOOLS_NOTEBOOK_GET_PRIVATE (notebook);
   
   notebook_page = autotools_notebook_page_new (output);
   notebook_tab = autotools_notebook_tab_new (GTK_WIDGET (notebook), label);
@@ -84,6 +146,20 @@ autotools_notebook_add_output (AutotoolsNotebook *notebook,
   g_signal_connect (G_OBJECT (notebook_tab), "close",
                     G_CALLBACK (close_action), notebook);
                                             
+  g_signal_connect (G_OBJECT (notebook_page), "stop",
+                    G_CALLBACK (stop_action), notebook);
+                                            
+  g_signal_connect (G_OBJECT (notebook_page), "export-trace",
+                    G_CALLBACK (export_trace_action), notebook);
+  
+  entry = g_malloc (sizeof (Entry));
+  entry->config = autotools_output_get_config (AUTOTOOLS_OUTPUT (output));
+  entry->notebook_page = notebook_page;
+  entry->output = output;
+  entry->page_num = -1;
+  g_hash_table_insert (priv->configs, entry->config, entry);
+  g_hash_table_insert (priv->outputs, output, entry);
+                                            
   gtk_notebook_append_page (GTK_NOTEBOOK (notebook), notebook_page, notebook_tab);
   gtk_notebook_set_tab_reorderable (GTK_NOTEBOOK (notebook), notebook_page, TRUE);
   
@@ -104,53 +180,102 @@ close_action (AutotoolsNotebookTab *notebook_tab,
   gtk_notebook_remove_page (GTK_NOTEBOOK (notebook), page_num);
 }
 
-GtkWidget*  
-autotools_notebook_get_output_by_config (AutotoolsNotebook *notebook, 
-                                         AutotoolsConfig   *config)
+static void
+stop_action (AutotoolsNotebookPage *notebook_page,
+             AutotoolsNotebook     *notebook)
+{
+  GtkWidget *output;
+  output = autotools_notebook_page_get_output (notebook_page);
+  g_signal_emit_by_name ((gpointer) notebook, "stop", output);
+}
+
+static void
+export_trace_action (AutotoolsNotebookPage *notebook_page,
+                     AutotoolsNotebook     *notebook)
+{
+  GtkWidget *output;
+  output = autotools_notebook_page_get_output (notebook_page);
+  g_signal_emit_by_name ((gpointer) notebook, "export-trace", output);
+}
+
+/*
+ * The pages are indexed by config and by output so that the engine can 
+ * dispatch without walking the tabs. Page numbers only change when a tab 
+ * is added, closed or dragged, so they are refreshed then.
+ */
+static void
+update_page_nums (AutotoolsNotebook *notebook)
 {
+  AutotoolsNotebookPrivate *priv;
   gint pages;
   gint i;
   
+  priv = AUTOTOOLS_NOTEBOOK_GET_PRIVATE (notebook);
+  
   pages = gtk_notebook_get_n_pages (GTK_NOTEBOOK (notebook));
 
   for (i = 0; i < pages; i++)
     {
       GtkWidget *notebook_page;
-      CodeSlayerProject *project;
-
-      GtkWidget *current_output;
-      AutotoolsConfig *current_config;
-      CodeSlayerProject *current_project;
+      GtkWidget *output;
+      Entry *entry;
       
       notebook_page = gtk_notebook_get_nth_page (GTK_NOTEBOOK (notebook), i);
+      output = autotools_notebook_page_get_output (AUTOTOOLS_NOTEBOOK_PAGE (notebook_page));
+      entry = g_hash_table_lookup (priv->outputs, output);
+      if (entry != NULL)
+        entry->page_num = i;
+    }
+}
 
-      current_output = autotools_notebook_page_get_output (AUTOTOOLS_NOTEBOOK_PAGE (notebook_page));    
-      current_config = autotools_output_get_config (AUTOTOOLS_OUTPUT (current_output));
-      current_project = autotools_config_get_project (AUTOTOOLS_CONFIG (current_config));
-      
-      project = autotools_config_get_project (AUTOTOOLS_CONFIG (config));
-      
-      if (current_project == project)
-        return current_output;
+static void
+page_removed_action (AutotoolsNotebook *notebook,
+                     GtkWidget         *notebook_page,
+                     guint              page_num)
+{
+  AutotoolsNotebookPrivate *priv;
+  GtkWidget *output;
+  Entry *entry;
+  
+  priv = AUTOTOOLS_NOTEBOOK_GET_PRIVATE (notebook);
+  
+  output = autotools_notebook_page_get_output (AUTOTOOLS_NOTEBOOK_PAGE (notebook_page));
+  entry = g_hash_table_lookup (priv->outputs, output);
+  if (entry != NULL)
+    {
+      g_hash_table_remove (priv->outputs, output);
+      g_hash_table_remove (priv->configs, entry->config);
     }
+  
+  update_page_nums (notebook);
+}
+
+GtkWidget*  
+autotools_notebook_get_output_by_config (AutotoolsNotebook *notebook, 
+                                         AutotoolsConfig   *config)
+{
+  AutotoolsNotebookPrivate *priv;
+  Entry *entry;
+  
+  priv = AUTOTOOLS_NOTEBOOK_GET_PRIVATE (notebook);
+  
+  entry = g_hash_table_lookup (priv->configs, config);
+  if (entry == NULL)
+    return NULL;
     
-  return NULL;    
+  return entry->output;
 }                                                 
 
 void        
 autotools_notebook_select_page_by_output (AutotoolsNotebook *notebook, 
                                           GtkWidget         *output)
 {
-  gint pages;
-  gint i;
+  AutotoolsNotebookPrivate *priv;
+  Entry *entry;
   
-  pages = gtk_notebook_get_n_pages (GTK_NOTEBOOK (notebook));
-
-  for (i = 0; i < pages; i++)
-    {
-      GtkWidget *notebook_page;
-      notebook_page = gtk_notebook_get_nth_page (GTK_NOTEBOOK (notebook), i);
-      if (autotools_notebook_page_get_output (AUTOTOOLS_NOTEBOOK_PAGE (notebook_page)) == output)
-        gtk_notebook_set_current_page (GTK_NOTEBOOK (notebook), i);
-    }
+  priv = AUTOTOOLS_NOTEBOOK_GET_PRIVATE (notebook);
+  
+  entry = g_hash_table_lookup (priv->outputs, output);
+  if (entry != NULL && entry->page_num >= 0)
+    gtk_notebook_set_current_page (GTK_NOTEBOOK (notebook), entry->page_num);
 }                                        
@@ -41,6 +41,9 @@ struct _AutotoolsNotebook
 struct _AutotoolsNotebookClass
 {
   GtkNotebookClass parent_class;
+
+  void (*stop) (AutotoolsNotebook *notebook);
+  void (*export_trace) (AutotoolsNotebook *notebook);
 };
 
 GType
@@ -52,8 +55,8 @@ void        autotools_notebook_add_output                   (AutotoolsNotebook
                                                              GtkWidget              *output, 
                                                              const gchar            *label);
 
-GtkWidget*  autotools_notebook_get_output_by_config  (AutotoolsNotebook      *notebook, 
-                                                             AutotoolsConfig *config);
+GtkWidget*  autotools_notebook_get_output_by_config        (AutotoolsNotebook      *notebook, 
+                                                             AutotoolsConfig        *config);
 
 void        autotools_notebook_select_page_by_output        (AutotoolsNotebook      *notebook, 
                                                              GtkWidget              *output);
@@ -19,18 +19,34 @@
 #include <stdlib.h>
 #include "autotools-output.h"
 
-typedef struct
-{
-  gchar *file_path;
-  gint   line_number;
-  gint   start_offset;
-  gint   end_offset;
-} Link;
+#define FLUSH_INTERVAL 16
+#define MAX_RUNS 20
 
 static void autotools_output_class_init      (AutotoolsOutputClass *klass);
 static void autotools_output_init            (AutotoolsOutput      *output);
 static void autotools_output_finalize        (AutotoolsOutput      *output);
 
+static gboolean flush_pending                (AutotoolsOutput      *output);
+static void trim_scrollback                  (AutotoolsOutput      *output,
+                                              GtkTextBuffer        *buffer);
+static void add_links                        (AutotoolsOutput      *output,
+                                              GtkTextBuffer        *buffer,
+                                              guint                 first);
+static const gchar* resolve_file             (AutotoolsOutput      *output,
+                                              guint32               file_id);
+static gboolean path_exists                  (AutotoolsOutput      *output,
+                                              const gchar          *file_path);
+static void clear_links                      (AutotoolsOutput      *output);
+static gboolean button_release_action        (AutotoolsOutput      *output,
+                                              GdkEventButton       *event);
+static gboolean motion_notify_action         (AutotoolsOutput      *output,
+                                              GdkEventMotion       *event);
+static gboolean get_iter_at_event            (AutotoolsOutput      *output,
+                                              gdouble               x,
+                                              gdouble               y,
+                                              GtkTextIter          *iter);
+static void free_run                         (AutotoolsRun         *run);
+
 #define AUTOTOOLS_OUTPUT_GET_PRIVATE(obj) \
   (G_TYPE_INSTANCE_GET_PRIVATE ((obj), AUTOTOOLS_OUTPUT_TYPE, AutotoolsOutputPrivate))
 
@@ -40,14 +56,40 @@ struct _AutotoolsOutputPrivate
 {
   AutotoolsConfig          *config;
   CodeSlayer               *codeslayer;
-  CodeSlayerDocumentLinker *linker;
+  GtkTextMark              *end_mark;
+  GtkTextTag               *link_tag;
+  AutotoolsDiagnostics     *diagnostics;
+  GPtrArray                *resolved_files;
+  GHashTable               *existing_paths;
+  gint64                    trimmed;
+  gboolean                  hovering;
+  GString                  *pending;
+  gboolean                  clear_pending;
+  guint                     flush_id;
+  GQueue                   *runs;
+};
+
+enum
+{
+  DIAGNOSTICS,
+  LAST_SIGNAL
 };
 
+static guint autotools_output_signals[LAST_SIGNAL] = { 0 };
+
 G_DEFINE_TYPE (AutotoolsOutput, autotools_output, GTK_TYPE_TEXT_VIEW)
       
 static void 
 autotools_output_class_init (AutotoolsOutputClass *klass)
 {
+  autotools_output_signals[DIAGNOSTICS] =
+    g_signal_new ("diagnostics", 
+                  G_TYPE_FROM_CLASS (klass),
+                  G_SIGNAL_RUN_LAST | G_SIGNAL_NO_RECURSE | G_SIGNAL_NO_HOOKS,
+                  G_STRUCT_OFFSET (AutotoolsOutputClass, diagnostics),
+                  NULL, NULL, 
+                  NULL, G_TYPE_NONE, 2, G_TYPE_UINT, G_TYPE_UINT);
+
   G_OBJECT_CLASS (klass)->finalize = (GObjectFinalizeFunc) autotools_output_finalize;
   g_type_class_add_private (klass, sizeof (AutotoolsOutputPrivate));
 }
@@ -55,6 +97,17 @@ autotools_output_class_init (AutotoolsOutputClass *klass)
 static void
 autotools_output_init (AutotoolsOutput *output) 
 {
+  AutotoolsOutputPrivate *priv;
+  priv = AUTOTOOLS_OUTPUT_GET_PRIVATE (output);
+  priv->pending = g_string_sized_new (BUFSIZ);
+  priv->clear_pending = FALSE;
+  priv->flush_id = 0;
+  priv->diagnostics = autotools_diagnostics_new ();
+  priv->resolved_files = g_ptr_array_new_with_free_func (g_free);
+  priv->existing_paths = g_hash_table_new_full (g_str_hash, g_str_equal, g_free, NULL);
+  priv->trimmed = 0;
+  priv->hovering = FALSE;
+  priv->runs = g_queue_new ();
   gtk_text_view_set_editable (GTK_TEXT_VIEW (output), FALSE);
   gtk_text_view_set_wrap_mode (GTK_TEXT_VIEW (output), GTK_WRAP_WORD);
 }
@@ -65,7 +118,15 @@ autotools_output_finalize (AutotoolsOutput *output)
   AutotoolsOutputPrivate *priv;
   priv = AUTOTOOLS_OUTPUT_GET_PRIVATE (output);
 
-  g_object_unref (priv->linker);
+  if (priv->flush_id)
+    g_source_remove (priv->flush_id);
+
+  g_string_free (priv->pending, TRUE);
+  g_object_unref (priv->diagnostics);
+  g_object_unref (priv->config);
+  g_ptr_array_free (priv->resolved_files, TRUE);
+  g_hash_table_destroy (priv->existing_paths);
+  g_queue_free_full (priv->runs, (GDestroyNotify) free_run);
 
   G_OBJECT_CLASS (autotools_output_parent_class)->finalize (G_OBJECT (output));
 }
@@ -76,13 +137,25 @@ autotools_output_new (AutotoolsConfig *config,
 {
   GtkWidget *output;
   AutotoolsOutputPrivate *priv;
+  GtkTextBuffer *buffer;
+  GtkTextIter iter;
  
   output = g_object_new (autotools_output_get_type (), NULL);
   priv = AUTOTOOLS_OUTPUT_GET_PRIVATE (output);
-  priv->config = config;
+  priv->config = g_object_ref (config);
   priv->codeslayer = codeslayer;
   
-  priv->linker = codeslayer_create_document_linker (codeslayer, GTK_TEXT_VIEW (output));
+  buffer = gtk_text_view_get_buffer (GTK_TEXT_VIEW (output));
+  gtk_text_buffer_get_end_iter (buffer, &iter);
+  priv->end_mark = gtk_text_buffer_create_mark (buffer, NULL, &iter, FALSE);
+  priv->link_tag = gtk_text_buffer_create_tag (buffer, NULL, 
+                                               "underline", PANGO_UNDERLINE_SINGLE, 
+                                               "foreground", "blue", NULL);
+  
+  g_signal_connect_swapped (G_OBJECT (output), "button-release-event",
+                            G_CALLBACK (button_release_action), output);
+  g_signal_connect_swapped (G_OBJECT (output), "motion-notify-event",
+                            G_CALLBACK (motion_notify_action), output);
 
   return output;
 }
@@ -103,10 +176,424 @@ autotools_output_get_codeslayer (AutotoolsOutput *output)
   return priv->codeslayer;
 }
 
+/*
+ * The text is collected into a pending buffer and inserted by a single 
+ * flush source, at most once per frame, so that a fast build does not 
+ * turn every read into a buffer insert and a scroll.
+ */
+void
+autotools_output_append_text (AutotoolsOutput *output,
+                              const gchar     *text,
+                              gssize           length)
+{
+  AutotoolsOutputPrivate *priv;
+  priv = AUTOTOOLS_OUTPUT_GET_PRIVATE (output);
+
+  g_string_append_len (priv->pending, text, length);
+  if (priv->flush_id == 0)
+    priv->flush_id = g_timeout_add (FLUSH_INTERVAL, (GSourceFunc) flush_pending, output);
+}
+
+void
+autotools_output_clear_text (AutotoolsOutput *output)
+{
+  AutotoolsOutputPrivate *priv;
+  priv = AUTOTOOLS_OUTPUT_GET_PRIVATE (output);
+
+  g_string_truncate (priv->pending, 0);
+  priv->clear_pending = TRUE;
+  if (priv->flush_id == 0)
+    priv->flush_id = g_timeout_add (FLUSH_INTERVAL, (GSourceFunc) flush_pending, output);
+}
+
+static gboolean
+flush_pending (AutotoolsOutput *output)
+{
+  AutotoolsOutputPrivate *priv;
+  GtkTextBuffer *buffer;
+  GtkTextIter iter;
+  GString *pending;
+  gboolean clear_pending;
+  
+  priv = AUTOTOOLS_OUTPUT_GET_PRIVATE (output);
+
+  pending = priv->pending;
+  clear_pending = priv->clear_pending;
+  priv->pending = g_string_sized_new (pending->len);
+  priv->clear_pending = FALSE;
+  priv->flush_id = 0;
+
+  buffer = gtk_text_view_get_buffer (GTK_TEXT_VIEW (output));
+  
+  if (clear_pending)
+    {
+      gtk_text_buffer_set_text (buffer, "", -1);
+      clear_links (output);
+    }
+
+  if (pending->len > 0)
+    {
+      gtk_text_buffer_get_end_iter (buffer, &iter);
+      gtk_text_buffer_insert (buffer, &iter, pending->str, pending->len);
+      add_links (output, buffer, 
+                 autotools_diagnostics_scan (priv->diagnostics, pending->str, pending->len));
+      trim_scrollback (output, buffer);
+      gtk_text_buffer_get_end_iter (buffer, &iter);
+      gtk_text_buffer_move_mark (buffer, priv->end_mark, &iter);
+      gtk_text_view_scroll_to_mark (GTK_TEXT_VIEW (output), priv->end_mark, 0.0, FALSE, 0, 0);
+    }
+
+  g_string_free (pending, TRUE);
+  return FALSE;
+}
+
+/*
+ * The scrollback can be limited by lines, by characters or by both. 
+ * Characters are what GTK counts cheaply, and the text is always cut at 
+ * the start of a line.
+ */
+static void
+trim_scrollback (AutotoolsOutput *output,
+                 GtkTextBuffer   *buffer)
+{
+  AutotoolsOutputPrivate *priv;
+  GtkTextIter start;
+  GtkTextIter end;
+  gint scrollback_lines;
+  gint scrollback_chars;
+  gint line_count;
+  gint char_count;
+  
+  priv = AUTOTOOLS_OUTPUT_GET_PRIVATE (output);
+  
+  scrollback_lines = autotools_config_get_scrollback_lines (priv->config);
+  scrollback_chars = autotools_config_get_scrollback_chars (priv->config);
+  
+  gtk_text_buffer_get_start_iter (buffer, &end);
+
+  line_count = gtk_text_buffer_get_line_count (buffer);
+  if (scrollback_lines > 0 && line_count > scrollback_lines)
+    gtk_text_buffer_get_iter_at_line (buffer, &end, line_count - scrollback_lines);
+
+  char_count = gtk_text_buffer_get_char_count (buffer);
+  if (scrollback_chars > 0 && 
+      char_count - gtk_text_iter_get_offset (&end) > scrollback_chars)
+    {
+      gtk_text_buffer_get_iter_at_offset (buffer, &end, char_count - scrollback_chars);
+      if (!gtk_text_iter_starts_line (&end))
+        gtk_text_iter_forward_line (&end);
+    }
+  
+  if (gtk_text_iter_get_offset (&end) == 0)
+    return;
+
+  gtk_text_buffer_get_start_iter (buffer, &start);
+  priv->trimmed += gtk_text_iter_get_offset (&end);
+  gtk_text_buffer_delete (buffer, &start, &end);
+  autotools_diagnostics_remove_before (priv->diagnostics, priv->trimmed);
+}
+
+/*
+ * The diagnostics are scanned as each chunk is flushed and only the new 
+ * ones are turned into links. All of the offsets are kept relative to the 
+ * start of the build, that way trimming the scrollback does not 
+ * invalidate them.
+ */
+static void
+add_links (AutotoolsOutput *output,
+           GtkTextBuffer   *buffer,
+           guint            first)
+{
+  AutotoolsOutputPrivate *priv;
+  guint length;
+  guint i;
+  
+  priv = AUTOTOOLS_OUTPUT_GET_PRIVATE (output);
+  
+  length = autotools_diagnostics_get_length (priv->diagnostics);
+  
+  for (i = first; i < length; i++)
+    {
+      AutotoolsDiagnostic *diagnostic;
+      GtkTextIter start;
+      GtkTextIter end;
+      
+      diagnostic = autotools_diagnostics_get (priv->diagnostics, i);
+      if (diagnostic->offset < priv->trimmed ||
+          resolve_file (output, diagnostic->file_id) == NULL)
+        continue;
+      
+      gtk_text_buffer_get_iter_at_offset (buffer, &start, (gint) (diagnostic->offset - priv->trimmed));
+      gtk_text_buffer_get_iter_at_offset (buffer, &end, 
+                                          (gint) (diagnostic->offset + diagnostic->length - priv->trimmed));
+      gtk_text_buffer_apply_tag (buffer, priv->link_tag, &start, &end);
+    }
+  
+  if (first < length)
+    g_signal_emit_by_name ((gpointer) output, "diagnostics", first, length);
+}
+
+/*
+ * Each distinct file name is only resolved once per build, a missing 
+ * file is cached as an empty string. A relative name is looked for in 
+ * the directories of the sub-makes that were running when it was 
+ * printed, in the order the scanner gives them, and then in the build 
+ * folder. Many names share those directories, so whether a path exists 
+ * is cached as well and each path is checked against the disk only once.
+ */
+static const gchar*
+resolve_file (AutotoolsOutput *output,
+              guint32          file_id)
+{
+  AutotoolsOutputPrivate *priv;
+  const gchar *file_name;
+  gchar *file_path;
+  guint i;
+  
+  priv = AUTOTOOLS_OUTPUT_GET_PRIVATE (output);
+  
+  if (file_id == AUTOTOOLS_DIAGNOSTIC_NO_FILE)
+    return NULL;
+  
+  if (file_id >= priv->resolved_files->len)
+    g_ptr_array_set_size (priv->resolved_files, 
+                          autotools_diagnostics_get_file_count (priv->diagnostics));
+                          
+  file_path = g_ptr_array_index (priv->resolved_files, file_id);
+  if (file_path != NULL)
+    return *file_path != '\0' ? file_path : NULL;
+
+  file_name = autotools_diagnostics_get_file (priv->diagnostics, file_id);
+  if (g_path_is_absolute (file_name))
+    {
+      file_path = g_strdup (file_name);
+    }
+  else
+    {
+      for (i = 0; (file_path = autotools_diagnostics_get_path (priv->diagnostics, file_id, i)) != NULL; i++)
+        {
+          if (path_exists (output, file_path))
+            break;
+          g_free (file_path);
+        }
+      if (file_path == NULL)
+        file_path = g_build_filename (autotools_config_get_build_folder (priv->config), 
+                                      file_name, NULL);
+    }
+  
+  if (!path_exists (output, file_path))
+    {
+      g_free (file_path);
+      file_path = g_strdup ("");
+    }
+  
+  g_ptr_array_index (priv->resolved_files, file_id) = file_path;
+  return *file_path != '\0' ? file_path : NULL;
+}
+
+static gboolean
+path_exists (AutotoolsOutput *output,
+             const gchar     *file_path)
+{
+  AutotoolsOutputPrivate *priv;
+  gpointer value;
+  gboolean exists;
+  
+  priv = AUTOTOOLS_OUTPUT_GET_PRIVATE (output);
+  
+  if (g_hash_table_lookup_extended (priv->existing_paths, file_path, NULL, &value))
+    return GPOINTER_TO_INT (value);
+  
+  exists = g_file_test (file_path, G_FILE_TEST_IS_REGULAR);
+  g_hash_table_insert (priv->existing_paths, g_strdup (file_path), GINT_TO_POINTER (exists));
+  return exists;
+}
+
+static void
+clear_links (AutotoolsOutput *output)
+{
+  AutotoolsOutputPrivate *priv;
+  priv = AUTOTOOLS_OUTPUT_GET_PRIVATE (output);
+  autotools_diagnostics_clear (priv->diagnostics);
+  g_ptr_array_set_size (priv->resolved_files, 0);
+  g_hash_table_remove_all (priv->existing_paths);
+  priv->trimmed = 0;
+}
+
+static gboolean
+get_iter_at_event (AutotoolsOutput *output,
+                   gdouble          x,
+                   gdouble          y,
+                   GtkTextIter     *iter)
+{
+  gint buffer_x;
+  gint buffer_y;
+  
+  gtk_text_view_window_to_buffer_coords (GTK_TEXT_VIEW (output), 
+                                         GTK_TEXT_WINDOW_WIDGET,
+                                         (gint) x, (gint) y, 
+                                         &buffer_x, &buffer_y);
+  gtk_text_view_get_iter_at_location (GTK_TEXT_VIEW (output), iter, 
+                                      buffer_x, buffer_y);
+  return TRUE;
+}
+
+static gboolean
+button_release_action (AutotoolsOutput *output,
+                       GdkEventButton  *event)
+{
+  AutotoolsOutputPrivate *priv;
+  GtkTextBuffer *buffer;
+  GtkTextIter start;
+  GtkTextIter end;
+  GtkTextIter iter;
+  CodeSlayerDocument *document;
+  CodeSlayerProject *project;
+  AutotoolsDiagnostic *diagnostic;
+  const gchar *file_path;
+  
+  priv = AUTOTOOLS_OUTPUT_GET_PRIVATE (output);
+  
+  if (event->button != 1)
+    return FALSE;
+
+  buffer = gtk_text_view_get_buffer (GTK_TEXT_VIEW (output));
+  if (gtk_text_buffer_get_selection_bounds (buffer, &start, &end))
+    return FALSE;
+    
+  get_iter_at_event (output, event->x, event->y, &iter);
+  diagnostic = autotools_diagnostics_find (priv->diagnostics, 
+                                           gtk_text_iter_get_offset (&iter) + priv->trimmed);
+  if (diagnostic == NULL)
+    return FALSE;
+    
+  file_path = resolve_file (output, diagnostic->file_id);
+  if (file_path == NULL)
+    return FALSE;
+
+  document = codeslayer_document_new ();
+  codeslayer_document_set_file_path (document, file_path);
+  codeslayer_document_set_line_number (document, diagnostic->line);
+  project = codeslayer_get_project_by_file_path (priv->codeslayer, file_path);
+  codeslayer_document_set_project (document, project);
+  codeslayer_select_document (priv->codeslayer, document);
+  g_object_unref (document);
+  
+  return FALSE;
+}
+
+static gboolean
+motion_notify_action (AutotoolsOutput *output,
+                      GdkEventMotion  *event)
+{
+  AutotoolsOutputPrivate *priv;
+  GtkTextIter iter;
+  gboolean hovering;
+  
+  priv = AUTOTOOLS_OUTPUT_GET_PRIVATE (output);
+
+  get_iter_at_event (output, event->x, event->y, &iter);
+  hovering = gtk_text_iter_has_tag (&iter, priv->link_tag);
+  
+  if (hovering != priv->hovering)
+    {
+      GdkWindow *window;
+      GdkCursor *cursor;
+      priv->hovering = hovering;
+      window = gtk_text_view_get_window (GTK_TEXT_VIEW (output), GTK_TEXT_WINDOW_TEXT);
+      cursor = gdk_cursor_new (hovering ? GDK_HAND2 : GDK_XTERM);
+      gdk_window_set_cursor (window, cursor);
+      g_object_unref (cursor);
+    }
+  
+  return FALSE;
+}
+
 void
 autotools_output_create_links (AutotoolsOutput *output)
 {
   AutotoolsOutputPrivate *priv;
+  GtkTextBuffer *buffer;
   priv = AUTOTOOLS_OUTPUT_GET_PRIVATE (output);
-  codeslayer_document_linker_create_links (priv->linker);
+
+  if (priv->flush_id)
+    {
+      g_source_remove (priv->flush_id);
+      priv->flush_id = 0;
+    }
+  
+  flush_pending (output);
+  
+  buffer = gtk_text_view_get_buffer (GTK_TEXT_VIEW (output));
+  add_links (output, buffer, autotools_diagnostics_finish (priv->diagnostics));
+}
+
+AutotoolsDiagnostics*
+autotools_output_get_diagnostics (AutotoolsOutput *output)
+{
+  AutotoolsOutputPrivate *priv;
+  priv = AUTOTOOLS_OUTPUT_GET_PRIVATE (output);
+  return priv->diagnostics;
+}
+
+/*
+ * Keeps the usage of the most recent runs, newest first, so that one 
+ * build can be compared with the ones before it.
+ */
+void
+autotools_output_add_run (AutotoolsOutput             *output,
+                          const gchar                 *command,
+                          const AutotoolsProcessUsage *usage)
+{
+  AutotoolsOutputPrivate *priv;
+  AutotoolsRun *run;
+  
+  priv = AUTOTOOLS_OUTPUT_GET_PRIVATE (output);
+  
+  run = g_malloc (sizeof (AutotoolsRun));
+  run->command = g_strdup (command);
+  run->finished = g_get_real_time ();
+  run->usage = *usage;
+  g_queue_push_head (priv->runs, run);
+  
+  while (g_queue_get_length (priv->runs) > MAX_RUNS)
+    free_run (g_queue_pop_tail (priv->runs));
+}
+
+GList*
+autotools_output_get_runs (AutotoolsOutput *output)
+{
+  AutotoolsOutputPrivate *priv;
+  priv = AUTOTOOLS_OUTPUT_GET_PRIVATE (output);
+  return priv->runs->head;
+}
+
+static void
+free_run (AutotoolsRun *run)
+{
+  g_free (run->command);
+  g_free (run);
+}
+
+/*
+ * The path of a diagnostic's file as it is linked in the output, or the 
+ * name the compiler printed when it could not be found.
+ */
+const gchar*
+autotools_output_get_file (AutotoolsOutput *output,
+                           guint32          file_id)
+{
+  AutotoolsOutputPrivate *priv;
+  const gchar *file_path;
+  
+  priv = AUTOTOOLS_OUTPUT_GET_PRIVATE (output);
+  
+  if (file_id == AUTOTOOLS_DIAGNOSTIC_NO_FILE)
+    return NULL;
+  
+  file_path = resolve_file (output, file_id);
+  if (file_path != NULL)
+    return file_path;
+  
+  return autotools_diagnostics_get_file (priv->diagnostics, file_id);
 }
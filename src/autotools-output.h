@@ -22,6 +22,8 @@
 #include <gtk/gtk.h>
 #include <codeslayer/codeslayer.h>
 #include "autotools-config.h"
+#include "autotools-diagnostics.h"
+#include "autotools-process.h"
 
 G_BEGIN_DECLS
 
@@ -34,6 +36,13 @@ G_BEGIN_DECLS
 typedef struct _AutotoolsOutput AutotoolsOutput;
 typedef struct _AutotoolsOutputClass AutotoolsOutputClass;
 
+typedef struct
+{
+  gchar                 *command;
+  gint64                 finished;
+  AutotoolsProcessUsage  usage;
+} AutotoolsRun;
+
 struct _AutotoolsOutput
 {
   GtkTextView parent_instance;
@@ -42,6 +51,8 @@ struct _AutotoolsOutput
 struct _AutotoolsOutputClass
 {
   GtkTextViewClass parent_class;
+
+  void (*diagnostics) (AutotoolsOutput *output);
 };
 
 GType autotools_output_get_type (void) G_GNUC_CONST;
@@ -51,7 +62,18 @@ GtkWidget*               autotools_output_new               (AutotoolsConfig *co
 
 AutotoolsConfig*  autotools_output_get_config (AutotoolsOutput        *output);
 CodeSlayer*              autotools_output_get_codeslayer    (AutotoolsOutput        *output);
+void                     autotools_output_append_text       (AutotoolsOutput        *output,
+                                                             const gchar            *text,
+                                                             gssize                  length);
+void                     autotools_output_clear_text        (AutotoolsOutput        *output);
 void                     autotools_output_create_links      (AutotoolsOutput        *output);
+AutotoolsDiagnostics*    autotools_output_get_diagnostics   (AutotoolsOutput        *output);
+void                     autotools_output_add_run           (AutotoolsOutput             *output,
+                                                             const gchar                 *command,
+                                                             const AutotoolsProcessUsage *usage);
+GList*                   autotools_output_get_runs          (AutotoolsOutput        *output);
+const gchar*             autotools_output_get_file          (AutotoolsOutput        *output,
+                                                             guint32                 file_id);
 
 G_END_DECLS
 
@@ -0,0 +1,408 @@
+/*
+ * Copyright (C) 2010 - Jeff Johnston
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+ */
+
+#define _GNU_SOURCE
+#include <string.h>
+#include <errno.h>
+#include <unistd.h>
+#include <signal.h>
+#include <sys/types.h>
+#include <sys/time.h>
+#include <sys/resource.h>
+#include <sys/wait.h>
+#include "autotools-process.h"
+
+#define CHUNK_SIZE 65536
+#define MAX_LINE_SIZE 1048576
+#define STOP_GRACE_PERIOD 2000
+
+static void autotools_process_class_init  (AutotoolsProcessClass *klass);
+static void autotools_process_init        (AutotoolsProcess      *process);
+static void autotools_process_finalize    (AutotoolsProcess      *process);
+
+static gboolean read_action               (GIOChannel            *channel,
+                                           GIOCondition           condition,
+                                           AutotoolsProcess      *process);
+typedef struct
+{
+  AutotoolsProcess *process;
+  GMainContext     *context;
+  GPid              pid;
+  gboolean          reaped;
+  gint              status;
+  struct rusage     rusage;
+} Reap;
+
+static gpointer reap_thread               (Reap                  *reap);
+static gboolean reap_action               (Reap                  *reap);
+static void emit_lines                    (AutotoolsProcess      *process,
+                                           gsize                  length);
+static void check_finished                (AutotoolsProcess      *process);
+static void child_setup                   (gpointer               user_data);
+static gboolean kill_action               (AutotoolsProcess      *process);
+
+#define AUTOTOOLS_PROCESS_GET_PRIVATE(obj) \
+  (G_TYPE_INSTANCE_GET_PRIVATE ((obj), AUTOTOOLS_PROCESS_TYPE, AutotoolsProcessPrivate))
+
+typedef struct _AutotoolsProcessPrivate AutotoolsProcessPrivate;
+
+struct _AutotoolsProcessPrivate
+{
+  GPid        pid;
+  GIOChannel *channel;
+  guint       read_id;
+  guint       kill_id;
+  gboolean    closed;
+  gboolean    exited;
+  GString    *buffer;
+  GTimer     *timer;
+  
+  AutotoolsProcessUsage usage;
+};
+
+enum
+{
+  OUTPUT,
+  FINISHED,
+  LAST_SIGNAL
+};
+
+static guint autotools_process_signals[LAST_SIGNAL] = { 0 };
+
+G_DEFINE_TYPE (AutotoolsProcess, autotools_process, G_TYPE_OBJECT)
+
+static void
+autotools_process_class_init (AutotoolsProcessClass *klass)
+{
+  GObjectClass *gobject_class = G_OBJECT_CLASS (klass);
+
+  autotools_process_signals[OUTPUT] =
+    g_signal_new ("output", 
+                  G_TYPE_FROM_CLASS (klass),
+                  G_SIGNAL_RUN_LAST | G_SIGNAL_NO_RECURSE | G_SIGNAL_NO_HOOKS,
+                  G_STRUCT_OFFSET (AutotoolsProcessClass, output),
+                  NULL, NULL, 
+                  g_cclosure_marshal_VOID__STRING, G_TYPE_NONE, 1, G_TYPE_STRING);
+
+  autotools_process_signals[FINISHED] =
+    g_signal_new ("finished", 
+                  G_TYPE_FROM_CLASS (klass),
+                  G_SIGNAL_RUN_LAST | G_SIGNAL_NO_RECURSE | G_SIGNAL_NO_HOOKS,
+                  G_STRUCT_OFFSET (AutotoolsProcessClass, finished),
+                  NULL, NULL, 
+                  g_cclosure_marshal_VOID__INT, G_TYPE_NONE, 1, G_TYPE_INT);
+
+  gobject_class->finalize = (GObjectFinalizeFunc) autotools_process_finalize;
+  g_type_class_add_private (klass, sizeof (AutotoolsProcessPrivate));
+}
+
+static void
+autotools_process_init (AutotoolsProcess *process)
+{
+  AutotoolsProcessPrivate *priv;
+  priv = AUTOTOOLS_PROCESS_GET_PRIVATE (process);
+  priv->pid = 0;
+  priv->channel = NULL;
+  priv->read_id = 0;
+  priv->kill_id = 0;
+  priv->closed = FALSE;
+  priv->exited = FALSE;
+  priv->buffer = g_string_sized_new (CHUNK_SIZE);
+  priv->timer = g_timer_new ();
+  memset (&priv->usage, 0, sizeof (AutotoolsProcessUsage));
+}
+
+static void
+autotools_process_finalize (AutotoolsProcess *process)
+{
+  AutotoolsProcessPrivate *priv;
+  priv = AUTOTOOLS_PROCESS_GET_PRIVATE (process);
+  
+  if (priv->read_id)
+    g_source_remove (priv->read_id);
+  if (priv->kill_id)
+    g_source_remove (priv->kill_id);
+  if (priv->channel)
+    g_io_channel_unref (priv->channel);
+  if (priv->pid)
+    g_spawn_close_pid (priv->pid);
+
+  g_string_free (priv->buffer, TRUE);
+  g_timer_destroy (priv->timer);
+  
+  G_OBJECT_CLASS (autotools_process_parent_class)->finalize (G_OBJECT (process));
+}
+
+AutotoolsProcess*
+autotools_process_new (void)
+{
+  return AUTOTOOLS_PROCESS (g_object_new (autotools_process_get_type (), NULL));
+}
+
+/*
+ * The child is read through a non-blocking channel watched on the main 
+ * context, only the wait for its exit has a thread. The finished signal is 
+ * only emitted once the output has been drained and the child reaped. 
+ * Each child leads its own process group so that stopping it also stops 
+ * everything make started. The process holds a reference on itself until 
+ * then, so the child is always reaped even if the caller lets go early.
+ */
+gboolean
+autotools_process_start (AutotoolsProcess  *process,
+                         const gchar       *working_directory,
+                         gchar            **argv,
+                         gchar            **envp,
+                         GError           **error)
+{
+  AutotoolsProcessPrivate *priv;
+  gint standard_output;
+  Reap *reap;
+  
+  priv = AUTOTOOLS_PROCESS_GET_PRIVATE (process);
+
+  if (!g_spawn_async_with_pipes (working_directory, argv, envp, 
+                                 G_SPAWN_SEARCH_PATH_FROM_ENVP | G_SPAWN_DO_NOT_REAP_CHILD,
+                                 child_setup, NULL, &priv->pid, 
+                                 NULL, &standard_output, NULL, error))
+    return FALSE;
+  
+  /* child_setup does the same, so the group exists whichever runs first */
+  setpgid (priv->pid, priv->pid);
+  
+  priv->channel = g_io_channel_unix_new (standard_output);
+  g_io_channel_set_close_on_unref (priv->channel, TRUE);
+  g_io_channel_set_flags (priv->channel, G_IO_FLAG_NONBLOCK, NULL);
+  
+  priv->read_id = g_io_add_watch (priv->channel, G_IO_IN | G_IO_HUP | G_IO_ERR, 
+                                  (GIOFunc) read_action, process);
+  g_timer_start (priv->timer);
+  g_object_ref (process);
+  
+  reap = g_malloc0 (sizeof (Reap));
+  reap->process = process;
+  reap->context = g_main_context_ref_thread_default ();
+  reap->pid = priv->pid;
+  g_thread_unref (g_thread_new ("autotools-reap", (GThreadFunc) reap_thread, reap));
+  return TRUE;
+}
+
+/*
+ * Runs in the child just before the exec. Error output goes to the same 
+ * pipe as the standard output so that the two stay in order.
+ */
+static void
+child_setup (gpointer user_data)
+{
+  setpgid (0, 0);
+  dup2 (STDOUT_FILENO, STDERR_FILENO);
+}
+
+gboolean
+autotools_process_is_running (AutotoolsProcess *process)
+{
+  return AUTOTOOLS_PROCESS_GET_PRIVATE (process)->pid != 0;
+}
+
+const AutotoolsProcessUsage*
+autotools_process_get_usage (AutotoolsProcess *process)
+{
+  return &AUTOTOOLS_PROCESS_GET_PRIVATE (process)->usage;
+}
+
+/*
+ * Asks the whole process group to terminate and, if anything is still 
+ * around after the grace period, kills it outright. When the group 
+ * cannot be signalled the child itself still is.
+ */
+void
+autotools_process_stop (AutotoolsProcess *process)
+{
+  AutotoolsProcessPrivate *priv;
+  priv = AUTOTOOLS_PROCESS_GET_PRIVATE (process);
+  
+  if (priv->pid == 0 || priv->kill_id != 0)
+    return;
+  
+  if (kill (-priv->pid, SIGTERM) != 0)
+    kill (priv->pid, SIGTERM);
+  priv->kill_id = g_timeout_add (STOP_GRACE_PERIOD, (GSourceFunc) kill_action, process);
+}
+
+static gboolean
+kill_action (AutotoolsProcess *process)
+{
+  AutotoolsProcessPrivate *priv;
+  priv = AUTOTOOLS_PROCESS_GET_PRIVATE (process);
+  priv->kill_id = 0;
+  if (priv->pid != 0 && kill (-priv->pid, SIGKILL) != 0)
+    kill (priv->pid, SIGKILL);
+  return FALSE;
+}
+
+/*
+ * Reads straight from the pipe in large blocks and only hands whole lines 
+ * on, the partial line at the end of a block is carried over to the next 
+ * read. That way a long libtool line is never split in two no matter how 
+ * it arrives.
+ */
+static gboolean
+read_action (GIOChannel       *channel,
+             GIOCondition      condition,
+             AutotoolsProcess *process)
+{
+  AutotoolsProcessPrivate *priv;
+  gsize length;
+  gssize bytes_read;
+  const gchar *newline;
+  
+  priv = AUTOTOOLS_PROCESS_GET_PRIVATE (process);
+  
+  length = priv->buffer->len;
+  g_string_set_size (priv->buffer, length + CHUNK_SIZE);
+  
+  bytes_read = read (g_io_channel_unix_get_fd (channel), 
+                     priv->buffer->str + length, CHUNK_SIZE);
+  
+  if (bytes_read > 0)
+    {
+      g_string_set_size (priv->buffer, length + bytes_read);
+      newline = memrchr (priv->buffer->str + length, '\n', bytes_read);
+      if (newline != NULL)
+        emit_lines (process, newline - priv->buffer->str + 1);
+      else if (priv->buffer->len >= MAX_LINE_SIZE)
+        emit_lines (process, priv->buffer->len);
+      return TRUE;
+    }
+
+  g_string_set_size (priv->buffer, length);
+  
+  if (bytes_read < 0 && (errno == EAGAIN || errno == EINTR))
+    return TRUE;
+
+  if (priv->buffer->len > 0)
+    emit_lines (process, priv->buffer->len);
+
+  priv->read_id = 0;
+  priv->closed = TRUE;
+  check_finished (process);
+  return FALSE;
+}
+
+static void
+emit_lines (AutotoolsProcess *process,
+            gsize             length)
+{
+  AutotoolsProcessPrivate *priv;
+  gchar saved;
+  
+  priv = AUTOTOOLS_PROCESS_GET_PRIVATE (process);
+  
+  saved = priv->buffer->str[length];
+  priv->buffer->str[length] = '\0';
+  g_signal_emit_by_name ((gpointer) process, "output", priv->buffer->str);
+  priv->buffer->str[length] = saved;
+  
+  g_string_erase (priv->buffer, 0, length);
+}
+
+/*
+ * The child is reaped with wait4 rather than a GLib child watch so that 
+ * its resource usage comes back with the exit status, a child watch 
+ * reaps the child itself and the usage would be lost. The wait blocks in 
+ * a thread of its own, so the exit is noticed as soon as it happens 
+ * without waking the main loop to poll, and the result is handed back 
+ * to the context the process was started in. The usage covers 
+ * everything the child waited for as well. The child is make, configure 
+ * or autoreconf itself, not a shell, so that is every compiler, linker 
+ * and test program the step started.
+ */
+static gpointer
+reap_thread (Reap *reap)
+{
+  GSource *source;
+  pid_t pid;
+  
+  do
+    pid = wait4 (reap->pid, &reap->status, 0, &reap->rusage);
+  while (pid < 0 && errno == EINTR);
+  
+  reap->reaped = pid > 0;
+  
+  source = g_idle_source_new ();
+  g_source_set_callback (source, (GSourceFunc) reap_action, reap, NULL);
+  g_source_attach (source, reap->context);
+  g_source_unref (source);
+  
+  return NULL;
+}
+
+static gboolean
+reap_action (Reap *reap)
+{
+  AutotoolsProcessPrivate *priv;
+  AutotoolsProcess *process;
+  
+  process = reap->process;
+  priv = AUTOTOOLS_PROCESS_GET_PRIVATE (process);
+  
+  g_timer_stop (priv->timer);
+
+  if (!reap->reaped)
+    {
+      priv->usage.status = -1;
+    }
+  else
+    {
+      priv->usage.status = reap->status;
+      priv->usage.user_time = reap->rusage.ru_utime.tv_sec + reap->rusage.ru_utime.tv_usec / 1e6;
+      priv->usage.system_time = reap->rusage.ru_stime.tv_sec + reap->rusage.ru_stime.tv_usec / 1e6;
+      priv->usage.max_rss = reap->rusage.ru_maxrss;
+      priv->usage.in_blocks = reap->rusage.ru_inblock;
+      priv->usage.out_blocks = reap->rusage.ru_oublock;
+    }
+  priv->usage.wall_time = g_timer_elapsed (priv->timer, NULL);
+  
+  g_main_context_unref (reap->context);
+  g_free (reap);
+  
+  priv->exited = TRUE;
+  check_finished (process);
+  return FALSE;
+}
+
+static void
+check_finished (AutotoolsProcess *process)
+{
+  AutotoolsProcessPrivate *priv;
+  priv = AUTOTOOLS_PROCESS_GET_PRIVATE (process);
+  
+  if (!priv->closed || !priv->exited)
+    return;
+  
+  g_spawn_close_pid (priv->pid);
+  priv->pid = 0;
+  
+  if (priv->kill_id)
+    {
+      g_source_remove (priv->kill_id);
+      priv->kill_id = 0;
+    }
+  
+  g_signal_emit_by_name ((gpointer) process, "finished", priv->usage.status);
+  g_object_unref (process);
+}
@@ -0,0 +1,75 @@
+/*
+ * Copyright (C) 2010 - Jeff Johnston
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+ */
+
+#ifndef __AUTOTOOLS_PROCESS_H__
+#define	__AUTOTOOLS_PROCESS_H__
+
+#include <gtk/gtk.h>
+
+G_BEGIN_DECLS
+
+#define AUTOTOOLS_PROCESS_TYPE            (autotools_process_get_type ())
+#define AUTOTOOLS_PROCESS(obj)            (G_TYPE_CHECK_INSTANCE_CAST ((obj), AUTOTOOLS_PROCESS_TYPE, AutotoolsProcess))
+#define AUTOTOOLS_PROCESS_CLASS(klass)    (G_TYPE_CHECK_CLASS_CAST ((klass), AUTOTOOLS_PROCESS_TYPE, AutotoolsProcessClass))
+#define IS_AUTOTOOLS_PROCESS(obj)         (G_TYPE_CHECK_INSTANCE_TYPE ((obj), AUTOTOOLS_PROCESS_TYPE))
+#define IS_AUTOTOOLS_PROCESS_CLASS(klass) (G_TYPE_CHECK_CLASS_TYPE ((klass), AUTOTOOLS_PROCESS_TYPE))
+
+typedef struct _AutotoolsProcess AutotoolsProcess;
+typedef struct _AutotoolsProcessClass AutotoolsProcessClass;
+
+typedef struct
+{
+  gint    status;
+  gdouble wall_time;
+  gdouble user_time;
+  gdouble system_time;
+  glong   max_rss;
+  glong   in_blocks;
+  glong   out_blocks;
+} AutotoolsProcessUsage;
+
+struct _AutotoolsProcess
+{
+  GObject parent_instance;
+};
+
+struct _AutotoolsProcessClass
+{
+  GObjectClass parent_class;
+
+  void (*output) (AutotoolsProcess *process);
+  void (*finished) (AutotoolsProcess *process);
+};
+
+GType autotools_process_get_type (void) G_GNUC_CONST;
+
+AutotoolsProcess*  autotools_process_new         (void);
+
+gboolean           autotools_process_start       (AutotoolsProcess  *process,
+                                                  const gchar       *working_directory,
+                                                  gchar            **argv,
+                                                  gchar            **envp,
+                                                  GError           **error);
+void               autotools_process_stop        (AutotoolsProcess  *process);
+gboolean           autotools_process_is_running  (AutotoolsProcess  *process);
+
+const AutotoolsProcessUsage*  autotools_process_get_usage  (AutotoolsProcess *process);
+
+G_END_DECLS
+
+#endif /* __AUTOTOOLS_PROCESS_H__ */
@@ -16,6 +16,7 @@
  * Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
  */
 
+#include <string.h>
 #include "autotools-project-properties.h"
 
 static void autotools_project_properties_class_init  (AutotoolsProjectPropertiesClass *klass);
@@ -34,6 +35,11 @@ static void build_folder_icon_action              (GtkEntry
                                                       GdkEvent                         *event,
                                                       AutotoolsProjectProperties       *project_properties);
 static gboolean entry_has_text                       (GtkWidget                        *entry);
+static gchar* get_environment_text                   (gchar                           **environment);
+static gchar** parse_environment_text                (const gchar                      *text,
+                                                      GError                          **error);
+static gchar* get_configurations_text                (gchar                           **configurations);
+static gchar** parse_configurations_text             (const gchar                      *text);
 
 
 #define AUTOTOOLS_PROJECT_PROPERTIES_GET_PRIVATE(obj) \
@@ -47,6 +53,15 @@ struct _AutotoolsProjectPropertiesPrivate
   GtkWidget         *configure_file_entry;
   GtkWidget         *configure_parameters_entry;
   GtkWidget         *build_folder_entry;
+  GtkWidget         *jobs_spin;
+  GtkWidget         *load_average_spin;
+  GtkWidget         *configure_cache_combo;
+  GtkWidget         *compiler_launcher_entry;
+  GtkWidget         *build_on_save_check;
+  GtkWidget         *build_on_save_delay_spin;
+  GtkWidget         *profile_targets_check;
+  GtkWidget         *environment_entry;
+  GtkWidget         *configurations_entry;
 };
 
 enum
@@ -109,6 +124,31 @@ add_form (AutotoolsProjectProperties *project_properties)
   GtkWidget *build_folder_label;
   GtkWidget *build_folder_entry;
 
+  GtkWidget *jobs_label;
+  GtkWidget *jobs_spin;
+
+  GtkWidget *load_average_label;
+  GtkWidget *load_average_spin;
+
+  GtkWidget *configure_cache_label;
+  GtkWidget *configure_cache_combo;
+
+  GtkWidget *compiler_launcher_label;
+  GtkWidget *compiler_launcher_entry;
+
+  GtkWidget *build_on_save_label;
+  GtkWidget *build_on_save_box;
+  GtkWidget *build_on_save_check;
+  GtkWidget *build_on_save_delay_spin;
+
+  GtkWidget *profile_targets_label;
+  GtkWidget *profile_targets_check;
+
+  GtkWidget *environment_label;
+  GtkWidget *environment_entry;
+  GtkWidget *configurations_label;
+  GtkWidget *configurations_entry;
+
   priv = AUTOTOOLS_PROJECT_PROPERTIES_GET_PRIVATE (project_properties);
 
   grid = gtk_grid_new ();
@@ -151,6 +191,113 @@ add_form (AutotoolsProjectProperties *project_properties)
   gtk_grid_attach_next_to (GTK_GRID (grid), build_folder_entry, build_folder_label, 
                            GTK_POS_RIGHT, 1, 1);
                       
+  jobs_label = gtk_label_new (_("Parallel Jobs:"));
+  gtk_misc_set_alignment (GTK_MISC (jobs_label), 1, .5);
+  gtk_misc_set_padding (GTK_MISC (jobs_label), 4, 0);
+  gtk_grid_attach (GTK_GRID (grid), jobs_label, 0, 3, 1, 1);
+  
+  jobs_spin = gtk_spin_button_new_with_range (0, 256, 1);
+  priv->jobs_spin = jobs_spin;
+  gtk_widget_set_halign (jobs_spin, GTK_ALIGN_START);
+  gtk_widget_set_tooltip_text (jobs_spin, _("Number of jobs make runs at once (0 for the number of processors)"));
+  gtk_grid_attach_next_to (GTK_GRID (grid), jobs_spin, jobs_label, 
+                           GTK_POS_RIGHT, 1, 1);
+                      
+  load_average_label = gtk_label_new (_("Load Average Limit:"));
+  gtk_misc_set_alignment (GTK_MISC (load_average_label), 1, .5);
+  gtk_misc_set_padding (GTK_MISC (load_average_label), 4, 0);
+  gtk_grid_attach (GTK_GRID (grid), load_average_label, 0, 4, 1, 1);
+  
+  load_average_spin = gtk_spin_button_new_with_range (0, 256, 0.5);
+  priv->load_average_spin = load_average_spin;
+  gtk_spin_button_set_digits (GTK_SPIN_BUTTON (load_average_spin), 1);
+  gtk_widget_set_halign (load_average_spin, GTK_ALIGN_START);
+  gtk_widget_set_tooltip_text (load_average_spin, _("Do not start new jobs while the load average is above this value (0 for no limit)"));
+  gtk_grid_attach_next_to (GTK_GRID (grid), load_average_spin, load_average_label, 
+                           GTK_POS_RIGHT, 1, 1);
+                      
+  configure_cache_label = gtk_label_new (_("Configure Cache:"));
+  gtk_misc_set_alignment (GTK_MISC (configure_cache_label), 1, .5);
+  gtk_misc_set_padding (GTK_MISC (configure_cache_label), 4, 0);
+  gtk_grid_attach (GTK_GRID (grid), configure_cache_label, 0, 5, 1, 1);
+  
+  configure_cache_combo = gtk_combo_box_text_new ();
+  priv->configure_cache_combo = configure_cache_combo;
+  gtk_combo_box_text_append_text (GTK_COMBO_BOX_TEXT (configure_cache_combo), _("None"));
+  gtk_combo_box_text_append_text (GTK_COMBO_BOX_TEXT (configure_cache_combo), _("Project"));
+  gtk_combo_box_text_append_text (GTK_COMBO_BOX_TEXT (configure_cache_combo), _("Shared"));
+  gtk_widget_set_halign (configure_cache_combo, GTK_ALIGN_START);
+  gtk_widget_set_tooltip_text (configure_cache_combo, _("Keep the results of configure checks between runs, for this project only or shared by all projects with the same configure parameters"));
+  gtk_grid_attach_next_to (GTK_GRID (grid), configure_cache_combo, configure_cache_label, 
+                           GTK_POS_RIGHT, 1, 1);
+                      
+  compiler_launcher_label = gtk_label_new (_("Compiler Launcher:"));
+  gtk_misc_set_alignment (GTK_MISC (compiler_launcher_label), 1, .5);
+  gtk_misc_set_padding (GTK_MISC (compiler_launcher_label), 4, 0);
+  gtk_grid_attach (GTK_GRID (grid), compiler_launcher_label, 0, 6, 1, 1);
+  
+  compiler_launcher_entry = gtk_entry_new ();
+  priv->compiler_launcher_entry = compiler_launcher_entry;
+  gtk_entry_set_width_chars (GTK_ENTRY (compiler_launcher_entry), 50);
+  gtk_widget_set_tooltip_text (compiler_launcher_entry, _("Program put in front of CC and CXX when configuring, for example ccache"));
+  gtk_grid_attach_next_to (GTK_GRID (grid), compiler_launcher_entry, compiler_launcher_label, 
+                           GTK_POS_RIGHT, 1, 1);
+                      
+  build_on_save_label = gtk_label_new (_("Build On Save:"));
+  gtk_misc_set_alignment (GTK_MISC (build_on_save_label), 1, .5);
+  gtk_misc_set_padding (GTK_MISC (build_on_save_label), 4, 0);
+  gtk_grid_attach (GTK_GRID (grid), build_on_save_label, 0, 7, 1, 1);
+  
+  build_on_save_box = gtk_box_new (GTK_ORIENTATION_HORIZONTAL, 4);
+  
+  build_on_save_check = gtk_check_button_new ();
+  priv->build_on_save_check = build_on_save_check;
+  gtk_box_pack_start (GTK_BOX (build_on_save_box), build_on_save_check, FALSE, FALSE, 0);
+  
+  build_on_save_delay_spin = gtk_spin_button_new_with_range (100, 60000, 100);
+  priv->build_on_save_delay_spin = build_on_save_delay_spin;
+  gtk_widget_set_tooltip_text (build_on_save_delay_spin, _("Milliseconds to wait after the last save before make starts"));
+  gtk_box_pack_start (GTK_BOX (build_on_save_box), build_on_save_delay_spin, FALSE, FALSE, 0);
+  gtk_box_pack_start (GTK_BOX (build_on_save_box), gtk_label_new (_("ms")), FALSE, FALSE, 0);
+  
+  gtk_grid_attach_next_to (GTK_GRID (grid), build_on_save_box, build_on_save_label, 
+                           GTK_POS_RIGHT, 1, 1);
+                      
+  profile_targets_label = gtk_label_new (_("Profile Targets:"));
+  gtk_misc_set_alignment (GTK_MISC (profile_targets_label), 1, .5);
+  gtk_misc_set_padding (GTK_MISC (profile_targets_label), 4, 0);
+  gtk_grid_attach (GTK_GRID (grid), profile_targets_label, 0, 8, 1, 1);
+  
+  profile_targets_check = gtk_check_button_new ();
+  priv->profile_targets_check = profile_targets_check;
+  gtk_widget_set_tooltip_text (profile_targets_check, _("Time every make recipe and list the slowest targets after the build"));
+  gtk_grid_attach_next_to (GTK_GRID (grid), profile_targets_check, profile_targets_label, 
+                           GTK_POS_RIGHT, 1, 1);
+                      
+  environment_label = gtk_label_new (_("Environment:"));
+  gtk_misc_set_alignment (GTK_MISC (environment_label), 1, .5);
+  gtk_misc_set_padding (GTK_MISC (environment_label), 4, 0);
+  gtk_grid_attach (GTK_GRID (grid), environment_label, 0, 9, 1, 1);
+  
+  environment_entry = gtk_entry_new ();
+  priv->environment_entry = environment_entry;
+  gtk_entry_set_width_chars (GTK_ENTRY (environment_entry), 50);
+  gtk_widget_set_tooltip_text (environment_entry, _("Variables set for every command, for example CFLAGS=\"-O0 -g\" PATH=/opt/bin:$PATH"));
+  gtk_grid_attach_next_to (GTK_GRID (grid), environment_entry, environment_label, 
+                           GTK_POS_RIGHT, 1, 1);
+                      
+  configurations_label = gtk_label_new (_("Configurations:"));
+  gtk_misc_set_alignment (GTK_MISC (configurations_label), 1, .5);
+  gtk_misc_set_padding (GTK_MISC (configurations_label), 4, 0);
+  gtk_grid_attach (GTK_GRID (grid), configurations_label, 0, 10, 1, 1);
+  
+  configurations_entry = gtk_entry_new ();
+  priv->configurations_entry = configurations_entry;
+  gtk_entry_set_width_chars (GTK_ENTRY (configurations_entry), 50);
+  gtk_widget_set_tooltip_text (configurations_entry, _("Configurations to build, for example default debug asan. Each one other than default is a [configuration <name>] group in autotools.conf with its own build_folder and configure_parameters"));
+  gtk_grid_attach_next_to (GTK_GRID (grid), configurations_entry, configurations_label, 
+                           GTK_POS_RIGHT, 1, 1);
+                      
   gtk_box_pack_start (GTK_BOX (project_properties), grid, FALSE, FALSE, 3);
   
 
@@ -268,6 +415,9 @@ autotools_project_properties_opened (AutotoolsProjectProperties *project_propert
       const gchar *configure_file;
       const gchar *configure_parameters;
       const gchar *build_folder;
+      const gchar *compiler_launcher;
+      gchar *environment;
+      gchar *configurations;
     
       configure_file = autotools_config_get_configure_file (config);
       configure_parameters = autotools_config_get_configure_parameters (config);
@@ -276,12 +426,44 @@ autotools_project_properties_opened (AutotoolsProjectProperties *project_propert
       gtk_entry_set_text (GTK_ENTRY (priv->configure_file_entry), configure_file);
       gtk_entry_set_text (GTK_ENTRY (priv->configure_parameters_entry), configure_parameters);
       gtk_entry_set_text (GTK_ENTRY (priv->build_folder_entry), build_folder);
+      gtk_spin_button_set_value (GTK_SPIN_BUTTON (priv->jobs_spin), 
+                                 autotools_config_get_jobs (config));
+      gtk_spin_button_set_value (GTK_SPIN_BUTTON (priv->load_average_spin), 
+                                 autotools_config_get_load_average (config));
+      gtk_combo_box_set_active (GTK_COMBO_BOX (priv->configure_cache_combo), 
+                                autotools_config_get_configure_cache (config));
+      compiler_launcher = autotools_config_get_compiler_launcher (config);
+      gtk_entry_set_text (GTK_ENTRY (priv->compiler_launcher_entry), 
+                          compiler_launcher != NULL ? compiler_launcher : "");
+      gtk_toggle_button_set_active (GTK_TOGGLE_BUTTON (priv->build_on_save_check), 
+                                    autotools_config_get_build_on_save (config));
+      gtk_spin_button_set_value (GTK_SPIN_BUTTON (priv->build_on_save_delay_spin), 
+                                 autotools_config_get_build_on_save_delay (config));
+      gtk_toggle_button_set_active (GTK_TOGGLE_BUTTON (priv->profile_targets_check), 
+                                    autotools_config_get_profile_targets (config));
+      environment = get_environment_text (autotools_config_get_environment (config));
+      gtk_entry_set_text (GTK_ENTRY (priv->environment_entry), environment);
+      g_free (environment);
+      configurations = get_configurations_text (autotools_config_get_active_configurations (config));
+      gtk_entry_set_text (GTK_ENTRY (priv->configurations_entry), configurations);
+      g_free (configurations);
     }
   else
     {
       gtk_entry_set_text (GTK_ENTRY (priv->configure_file_entry), "");
       gtk_entry_set_text (GTK_ENTRY (priv->configure_parameters_entry), "");
       gtk_entry_set_text (GTK_ENTRY (priv->build_folder_entry), "");
+      gtk_spin_button_set_value (GTK_SPIN_BUTTON (priv->jobs_spin), 0);
+      gtk_spin_button_set_value (GTK_SPIN_BUTTON (priv->load_average_spin), 0);
+      gtk_combo_box_set_active (GTK_COMBO_BOX (priv->configure_cache_combo), 
+                                AUTOTOOLS_CONFIGURE_CACHE_NONE);
+      gtk_entry_set_text (GTK_ENTRY (priv->compiler_launcher_entry), "");
+      gtk_toggle_button_set_active (GTK_TOGGLE_BUTTON (priv->build_on_save_check), FALSE);
+      gtk_spin_button_set_value (GTK_SPIN_BUTTON (priv->build_on_save_delay_spin), 
+                                 AUTOTOOLS_CONFIG_DEFAULT_BUILD_ON_SAVE_DELAY);
+      gtk_toggle_button_set_active (GTK_TOGGLE_BUTTON (priv->profile_targets_check), FALSE);
+      gtk_entry_set_text (GTK_ENTRY (priv->environment_entry), "");
+      gtk_entry_set_text (GTK_ENTRY (priv->configurations_entry), "");
     }
 }
 
@@ -294,6 +476,20 @@ autotools_project_properties_saved (AutotoolsProjectProperties *project_properti
   gchar *configure_file;
   gchar *configure_parameters;
   gchar *build_folder;
+  gint jobs;
+  gdouble load_average;
+  AutotoolsConfigureCache configure_cache;
+  gchar *compiler_launcher;
+  gboolean build_on_save;
+  gint build_on_save_delay;
+  gboolean profile_targets;
+  gchar *environment_text;
+  gchar *current_environment_text;
+  gchar **environment;
+  gchar *configurations_text;
+  gchar *current_configurations_text;
+  gchar **configurations;
+  GError *error = NULL;
 
   priv = AUTOTOOLS_PROJECT_PROPERTIES_GET_PRIVATE (project_properties);
   
@@ -303,24 +499,80 @@ autotools_project_properties_saved (AutotoolsProjectProperties *project_properti
   
   g_strstrip (configure_file);
   g_strstrip (configure_parameters);
+  compiler_launcher = g_strdup (gtk_entry_get_text (GTK_ENTRY (priv->compiler_launcher_entry)));
+  
   g_strstrip (build_folder);
+  g_strstrip (compiler_launcher);
+  
+  jobs = gtk_spin_button_get_value_as_int (GTK_SPIN_BUTTON (priv->jobs_spin));
+  load_average = gtk_spin_button_get_value (GTK_SPIN_BUTTON (priv->load_average_spin));
+  configure_cache = gtk_combo_box_get_active (GTK_COMBO_BOX (priv->configure_cache_combo));
+  build_on_save = gtk_toggle_button_get_active (GTK_TOGGLE_BUTTON (priv->build_on_save_check));
+  build_on_save_delay = gtk_spin_button_get_value_as_int (GTK_SPIN_BUTTON (priv->build_on_save_delay_spin));
+  profile_targets = gtk_toggle_button_get_active (GTK_TOGGLE_BUTTON (priv->profile_targets_check));
+  environment = parse_environment_text (gtk_entry_get_text (GTK_ENTRY (priv->environment_entry)), &error);
+  if (environment == NULL)
+    {
+      GtkWidget *dialog;
+      dialog = gtk_message_dialog_new (NULL, GTK_DIALOG_MODAL, GTK_MESSAGE_ERROR, GTK_BUTTONS_OK,
+                                       "The environment was not saved: %s", error->message);
+      gtk_dialog_run (GTK_DIALOG (dialog));
+      gtk_widget_destroy (dialog);
+      g_error_free (error);
+      environment = g_strdupv (config != NULL ? autotools_config_get_environment (config) : NULL);
+    }
+  environment_text = get_environment_text (environment);
+  configurations = parse_configurations_text (gtk_entry_get_text (GTK_ENTRY (priv->configurations_entry)));
+  configurations_text = get_configurations_text (configurations);
   
   if (config != NULL)
     {
+      current_environment_text = get_environment_text (autotools_config_get_environment (config));
+      current_configurations_text = get_configurations_text (autotools_config_get_active_configurations (config));
+      
       if (g_strcmp0 (configure_file, autotools_config_get_configure_file (config)) == 0 &&
           g_strcmp0 (configure_parameters, autotools_config_get_configure_parameters (config)) == 0 &&
-          g_strcmp0 (build_folder, autotools_config_get_build_folder (config)) == 0)
+          g_strcmp0 (build_folder, autotools_config_get_build_folder (config)) == 0 &&
+          jobs == autotools_config_get_jobs (config) &&
+          load_average == autotools_config_get_load_average (config) &&
+          configure_cache == autotools_config_get_configure_cache (config) &&
+          g_strcmp0 (compiler_launcher, autotools_config_get_compiler_launcher (config) != NULL ? 
+                                        autotools_config_get_compiler_launcher (config) : "") == 0 &&
+          build_on_save == autotools_config_get_build_on_save (config) &&
+          build_on_save_delay == autotools_config_get_build_on_save_delay (config) &&
+          profile_targets == autotools_config_get_profile_targets (config) &&
+          g_strcmp0 (environment_text, current_environment_text) == 0 &&
+          g_strcmp0 (configurations_text, current_configurations_text) == 0)
         {
           g_free (configure_file);
           g_free (configure_parameters);
           g_free (build_folder);
+          g_free (compiler_launcher);
+          g_free (environment_text);
+          g_free (current_environment_text);
+          g_strfreev (environment);
+          g_free (configurations_text);
+          g_free (current_configurations_text);
+          g_strfreev (configurations);
           return;
         }
+      
+      g_free (current_environment_text);
+      g_free (current_configurations_text);
 
       autotools_config_set_project (config, project);
       autotools_config_set_configure_file (config, configure_file);
       autotools_config_set_configure_parameters (config, configure_parameters);
       autotools_config_set_build_folder (config, build_folder);
+      autotools_config_set_jobs (config, jobs);
+      autotools_config_set_load_average (config, load_average);
+      autotools_config_set_configure_cache (config, configure_cache);
+      autotools_config_set_compiler_launcher (config, compiler_launcher);
+      autotools_config_set_build_on_save (config, build_on_save);
+      autotools_config_set_build_on_save_delay (config, build_on_save_delay);
+      autotools_config_set_profile_targets (config, profile_targets);
+      autotools_config_set_environment (config, environment);
+      autotools_config_set_active_configurations (config, configurations);
       g_signal_emit_by_name((gpointer)project_properties, "save-config", config);
     }
   else if (entry_has_text (priv->configure_file_entry) &&
@@ -332,6 +584,15 @@ autotools_project_properties_saved (AutotoolsProjectProperties *project_properti
       autotools_config_set_configure_file (config, configure_file);
       autotools_config_set_configure_parameters (config, configure_parameters);
       autotools_config_set_build_folder (config, build_folder);
+      autotools_config_set_jobs (config, jobs);
+      autotools_config_set_load_average (config, load_average);
+      autotools_config_set_configure_cache (config, configure_cache);
+      autotools_config_set_compiler_launcher (config, compiler_launcher);
+      autotools_config_set_build_on_save (config, build_on_save);
+      autotools_config_set_build_on_save_delay (config, build_on_save_delay);
+      autotools_config_set_profile_targets (config, profile_targets);
+      autotools_config_set_environment (config, environment);
+      autotools_config_set_active_configurations (config, configurations);
       g_signal_emit_by_name((gpointer)project_properties, "save-config", config);
       g_object_unref (config);
     }
@@ -339,6 +600,11 @@ autotools_project_properties_saved (AutotoolsProjectProperties *project_properti
   g_free (configure_file);
   g_free (configure_parameters);
   g_free (build_folder);
+  g_free (compiler_launcher);
+  g_free (environment_text);
+  g_strfreev (environment);
+  g_free (configurations_text);
+  g_strfreev (configurations);
 }
 
 static gboolean
@@ -346,3 +612,101 @@ entry_has_text (GtkWidget *entry)
 {
   return gtk_entry_buffer_get_length (gtk_entry_get_buffer (GTK_ENTRY (entry))) > 0;
 }
+
+/*
+ * The environment is edited on one line as NAME=VALUE words that follow 
+ * the shell's quoting rules, so a value with spaces can be quoted. Words 
+ * that are not assignments are dropped. Text the shell could not read, 
+ * such as an unbalanced quote, is rejected and the environment the 
+ * project had is kept.
+ */
+static gchar*
+get_environment_text (gchar **environment)
+{
+  GString *text;
+  
+  text = g_string_new (NULL);
+  
+  for (; environment != NULL && *environment != NULL; environment++)
+    {
+      const gchar *value;
+      
+      if (text->len > 0)
+        g_string_append_c (text, ' ');
+      
+      value = strchr (*environment, '=') + 1;
+      if (strpbrk (value, " \t\"'\\") != NULL)
+        {
+          gchar *quoted;
+          quoted = g_shell_quote (value);
+          g_string_append_len (text, *environment, value - *environment);
+          g_string_append (text, quoted);
+          g_free (quoted);
+        }
+      else
+        {
+          g_string_append (text, *environment);
+        }
+    }
+  
+  return g_string_free (text, FALSE);
+}
+
+static gchar**
+parse_environment_text (const gchar  *text,
+                        GError      **error)
+{
+  GPtrArray *environment;
+  gchar **words = NULL;
+  gchar **word;
+  
+  while (g_ascii_isspace (*text))
+    text++;
+  
+  if (*text != '\0' && !g_shell_parse_argv (text, NULL, &words, error))
+    return NULL;
+  
+  environment = g_ptr_array_new ();
+  
+  for (word = words; word != NULL && *word != NULL; word++)
+    {
+      gchar *equals;
+      equals = strchr (*word, '=');
+      if (equals != NULL && equals != *word)
+        g_ptr_array_add (environment, g_strdup (*word));
+    }
+  g_strfreev (words);
+  
+  g_ptr_array_add (environment, NULL);
+  return (gchar **) g_ptr_array_free (environment, FALSE);
+}
+
+static gchar*
+get_configurations_text (gchar **configurations)
+{
+  if (configurations == NULL)
+    return g_strdup ("");
+  return g_strjoinv (" ", configurations);
+}
+
+/*
+ * The names are separated by spaces or commas.
+ */
+static gchar**
+parse_configurations_text (const gchar *text)
+{
+  GPtrArray *configurations;
+  gchar **names;
+  gchar **name;
+  
+  configurations = g_ptr_array_new ();
+  
+  names = g_strsplit_set (text, " \t,", -1);
+  for (name = names; *name != NULL; name++)
+    if (**name != '\0')
+      g_ptr_array_add (configurations, g_strdup (*name));
+  g_strfreev (names);
+  
+  g_ptr_array_add (configurations, NULL);
+  return (gchar **) g_ptr_array_free (configurations, FALSE);
+}
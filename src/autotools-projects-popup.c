@@ -36,6 +36,10 @@ static void configure_action                     (AutotoolsProjectsPopup      *p
                                                   GList                      *selections);
 static void autoreconf_action                    (AutotoolsProjectsPopup      *projects_popup, 
                                                   GList                      *selections);
+static void full_build_action                    (AutotoolsProjectsPopup      *projects_popup, 
+                                                  GList                      *selections);
+static void clear_configure_cache_action         (AutotoolsProjectsPopup      *projects_popup, 
+                                                  GList                      *selections);
                                         
 enum
 {
@@ -44,6 +48,8 @@ enum
   MAKE_CLEAN,
   AUTORECONF,
   CONFIGURE,
+  FULL_BUILD,
+  CLEAR_CONFIGURE_CACHE,
   LAST_SIGNAL
 };
 
@@ -94,6 +100,22 @@ autotools_projects_popup_class_init (AutotoolsProjectsPopupClass *klass)
                   NULL, NULL, 
                   g_cclosure_marshal_VOID__POINTER, G_TYPE_NONE, 1, G_TYPE_POINTER);
 
+  autotools_projects_popup_signals[FULL_BUILD] =
+    g_signal_new ("full-build", 
+                  G_TYPE_FROM_CLASS (klass),
+                  G_SIGNAL_RUN_LAST | G_SIGNAL_NO_RECURSE | G_SIGNAL_NO_HOOKS,
+                  G_STRUCT_OFFSET (AutotoolsProjectsPopupClass, full_build),
+                  NULL, NULL, 
+                  g_cclosure_marshal_VOID__POINTER, G_TYPE_NONE, 1, G_TYPE_POINTER);
+
+  autotools_projects_popup_signals[CLEAR_CONFIGURE_CACHE] =
+    g_signal_new ("clear-configure-cache", 
+                  G_TYPE_FROM_CLASS (klass),
+                  G_SIGNAL_RUN_LAST | G_SIGNAL_NO_RECURSE | G_SIGNAL_NO_HOOKS,
+                  G_STRUCT_OFFSET (AutotoolsProjectsPopupClass, clear_configure_cache),
+                  NULL, NULL, 
+                  g_cclosure_marshal_VOID__POINTER, G_TYPE_NONE, 1, G_TYPE_POINTER);
+
   G_OBJECT_CLASS (klass)->finalize = (GObjectFinalizeFunc) autotools_projects_popup_finalize;
 }
 
@@ -135,6 +157,9 @@ add_menu_items (AutotoolsProjectsPopup *projects_popup,
   GtkWidget *separator;
   GtkWidget *configure_item;
   GtkWidget *autoreconf_item;
+  GtkWidget *clear_configure_cache_item;
+  GtkWidget *full_build_separator;
+  GtkWidget *full_build_item;
 
   make_item = codeslayer_menu_item_new_with_label ("Make");
   gtk_menu_shell_append (GTK_MENU_SHELL (submenu), make_item);
@@ -154,6 +179,15 @@ add_menu_items (AutotoolsProjectsPopup *projects_popup,
   autoreconf_item = codeslayer_menu_item_new_with_label ("Autoreconf");
   gtk_menu_shell_append (GTK_MENU_SHELL (submenu), autoreconf_item);
 
+  clear_configure_cache_item = codeslayer_menu_item_new_with_label ("Clear Configure Cache");
+  gtk_menu_shell_append (GTK_MENU_SHELL (submenu), clear_configure_cache_item);
+
+  full_build_separator = gtk_separator_menu_item_new ();
+  gtk_menu_shell_append (GTK_MENU_SHELL (submenu), full_build_separator);
+
+  full_build_item = codeslayer_menu_item_new_with_label ("Full Build");
+  gtk_menu_shell_append (GTK_MENU_SHELL (submenu), full_build_item);
+
   g_signal_connect_swapped (G_OBJECT (make_item), "projects-menu-selected", 
                             G_CALLBACK (make_action), projects_popup);
    
@@ -168,6 +202,12 @@ add_menu_items (AutotoolsProjectsPopup *projects_popup,
 
   g_signal_connect_swapped (G_OBJECT (autoreconf_item), "projects-menu-selected", 
                             G_CALLBACK (autoreconf_action), projects_popup);
+
+  g_signal_connect_swapped (G_OBJECT (full_build_item), "projects-menu-selected", 
+                            G_CALLBACK (full_build_action), projects_popup);
+
+  g_signal_connect_swapped (G_OBJECT (clear_configure_cache_item), "projects-menu-selected", 
+                            G_CALLBACK (clear_configure_cache_action), projects_popup);
 }
 
 static void 
@@ -204,3 +244,17 @@ autoreconf_action (AutotoolsProjectsPopup *projects_popup,
 {
   g_signal_emit_by_name ((gpointer) projects_popup, "autoreconf", selections);
 }
+
+static void 
+full_build_action (AutotoolsProjectsPopup *projects_popup, 
+                   GList                  *selections) 
+{
+  g_signal_emit_by_name ((gpointer) projects_popup, "full-build", selections);
+}
+
+static void 
+clear_configure_cache_action (AutotoolsProjectsPopup *projects_popup, 
+                              GList                  *selections) 
+{
+  g_signal_emit_by_name ((gpointer) projects_popup, "clear-configure-cache", selections);
+}
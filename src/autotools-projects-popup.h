@@ -46,6 +46,8 @@ struct _AutotoolsProjectsPopupClass
   void (*make_clean) (AutotoolsProjectsPopup *menu);
   void (*configure) (AutotoolsProjectsPopup *menu);
   void (*autoreconf) (AutotoolsProjectsPopup *menu);
+  void (*full_build) (AutotoolsProjectsPopup *menu);
+  void (*clear_configure_cache) (AutotoolsProjectsPopup *menu);
 };
 
 GType autotools_projects_popup_get_type (void) G_GNUC_CONST;
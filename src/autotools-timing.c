@@ -0,0 +1,357 @@
+/*
+ * Copyright (C) 2010 - Jeff Johnston
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+ */
+
+#include <glib/gstdio.h>
+#include "autotools-timing.h"
+
+typedef struct
+{
+  gchar   *target;
+  gdouble  start;
+  gdouble  end;
+} Record;
+
+typedef struct
+{
+  gchar   *target;
+  gdouble  duration;
+} Timing;
+
+/*
+ * The wrapper is given to make as its SHELL together with the target 
+ * being built, so every recipe line runs through it. It appends one 
+ * record per line to the log named in the environment. Each record holds 
+ * the wrapper's own pid and the pid of the wrapper it runs under, if 
+ * any, which is how recipes that only start a sub-make are told apart 
+ * from the ones doing real work.
+ */
+static const gchar *shell_script =
+  "#!/bin/sh\n"
+  "target=$1\n"
+  "shift\n"
+  "parent=${AUTOTOOLS_TIMING_PARENT:-0}\n"
+  "AUTOTOOLS_TIMING_PARENT=$$\n"
+  "export AUTOTOOLS_TIMING_PARENT\n"
+  "start=`date +%s.%N`\n"
+  "/bin/sh \"$@\"\n"
+  "status=$?\n"
+  "end=`date +%s.%N`\n"
+  "echo \"$start $end $$ $parent $PWD/$target\" >> \"$AUTOTOOLS_TIMING_LOG\"\n"
+  "exit $status\n";
+
+static GPtrArray* read_records      (const gchar  *log_path);
+static gint compare_records         (Record      **record1, 
+                                     Record      **record2);
+static gint compare_timings         (Timing      **timing1, 
+                                     Timing      **timing2);
+static void append_json_string      (GString      *string,
+                                     const gchar  *text);
+static void free_record             (Record       *record);
+static void free_timing             (Timing       *timing);
+
+/*
+ * The script is compared with the one this build of the plugin carries 
+ * the first time it is asked for, and rewritten when it differs, so an 
+ * upgrade never keeps running an older script. After that it is only 
+ * written again if it went missing.
+ */
+const gchar*
+autotools_timing_get_shell (void)
+{
+  static gchar *shell_path = NULL;
+  static gboolean checked = FALSE;
+  
+  if (shell_path == NULL)
+    {
+      gchar *folder_path;
+      folder_path = g_build_filename (g_get_user_cache_dir (), "codeslayer", "autotools", NULL);
+      g_mkdir_with_parents (folder_path, 0755);
+      shell_path = g_build_filename (folder_path, "timing-shell", NULL);
+      g_free (folder_path);
+    }
+  
+  if (!checked || !g_file_test (shell_path, G_FILE_TEST_IS_EXECUTABLE))
+    {
+      gchar *contents = NULL;
+      
+      if (!g_file_get_contents (shell_path, &contents, NULL, NULL) ||
+          g_strcmp0 (contents, shell_script) != 0 ||
+          !g_file_test (shell_path, G_FILE_TEST_IS_EXECUTABLE))
+        {
+          if (!g_file_set_contents (shell_path, shell_script, -1, NULL))
+            {
+              g_free (contents);
+              return NULL;
+            }
+          g_chmod (shell_path, 0755);
+        }
+      
+      g_free (contents);
+      checked = TRUE;
+    }
+    
+  return shell_path;
+}
+
+gchar*
+autotools_timing_get_report (const gchar *log_path,
+                             gint         count)
+{
+  GPtrArray *records;
+  GHashTable *targets;
+  GPtrArray *timings;
+  GString *report;
+  gdouble first_start = G_MAXDOUBLE;
+  gdouble last_end = 0;
+  gdouble serial = 0;
+  gdouble wall;
+  guint i;
+  
+  records = read_records (log_path);
+  if (records == NULL)
+    return NULL;
+  
+  targets = g_hash_table_new (g_str_hash, g_str_equal);
+  timings = g_ptr_array_new_with_free_func ((GDestroyNotify) free_timing);
+  
+  for (i = 0; i < records->len; i++)
+    {
+      Record *record = g_ptr_array_index (records, i);
+      Timing *timing;
+      
+      first_start = MIN (first_start, record->start);
+      last_end = MAX (last_end, record->end);
+      serial += record->end - record->start;
+      
+      timing = g_hash_table_lookup (targets, record->target);
+      if (timing == NULL)
+        {
+          timing = g_malloc (sizeof (Timing));
+          timing->target = g_strdup (record->target);
+          timing->duration = 0;
+          g_hash_table_insert (targets, timing->target, timing);
+          g_ptr_array_add (timings, timing);
+        }
+      timing->duration += record->end - record->start;
+    }
+  
+  g_hash_table_destroy (targets);
+  g_ptr_array_free (records, TRUE);
+  
+  g_ptr_array_sort (timings, (GCompareFunc) compare_timings);
+  
+  report = g_string_new ("slowest targets:\n");
+  for (i = 0; i < timings->len && i < (guint) count; i++)
+    {
+      Timing *timing = g_ptr_array_index (timings, i);
+      g_string_append_printf (report, "%8.2fs  %s\n", timing->duration, timing->target);
+    }
+  
+  wall = last_end - first_start;
+  g_string_append_printf (report, "%d targets, %.1fs serial, %.1fs wall, parallelism %.1f\n", 
+                          timings->len, serial, wall, wall > 0 ? serial / wall : 1.0);
+  
+  g_ptr_array_free (timings, TRUE);
+  
+  return g_string_free (report, FALSE);
+}
+
+/*
+ * Writes the records as a trace event file that Chrome's about:tracing 
+ * and Perfetto can open. Make does not say which job slot ran a recipe, 
+ * so each recipe is put on the first lane that is free when it starts. 
+ * That gives as many lanes as there were jobs running at the busiest 
+ * point of the build, and gaps in a lane are idle time on that slot.
+ */
+gboolean
+autotools_timing_write_trace (const gchar  *log_path,
+                              const gchar  *trace_path,
+                              GError      **error)
+{
+  GPtrArray *records;
+  GArray *lanes;
+  GString *trace;
+  gdouble first_start;
+  gboolean result;
+  guint i;
+  
+  records = read_records (log_path);
+  if (records == NULL)
+    {
+      g_set_error (error, G_FILE_ERROR, G_FILE_ERROR_NOENT, 
+                   "no timings were recorded in %s", log_path);
+      return FALSE;
+    }
+  
+  g_ptr_array_sort (records, (GCompareFunc) compare_records);
+  first_start = ((Record*) g_ptr_array_index (records, 0))->start;
+  
+  lanes = g_array_new (FALSE, FALSE, sizeof (gdouble));
+  trace = g_string_new ("{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n");
+  
+  for (i = 0; i < records->len; i++)
+    {
+      Record *record = g_ptr_array_index (records, i);
+      guint lane;
+      
+      for (lane = 0; lane < lanes->len; lane++)
+        if (g_array_index (lanes, gdouble, lane) <= record->start)
+          break;
+      
+      if (lane == lanes->len)
+        g_array_append_val (lanes, record->end);
+      else
+        g_array_index (lanes, gdouble, lane) = record->end;
+      
+      g_string_append (trace, "{\"ph\":\"X\",\"cat\":\"make\",\"pid\":1,\"name\":");
+      append_json_string (trace, record->target);
+      g_string_append_printf (trace, ",\"tid\":%u,\"ts\":%.0f,\"dur\":%.0f},\n", lane + 1, 
+                              (record->start - first_start) * G_USEC_PER_SEC,
+                              (record->end - record->start) * G_USEC_PER_SEC);
+    }
+  
+  for (i = 0; i < lanes->len; i++)
+    g_string_append_printf (trace, "{\"ph\":\"M\",\"pid\":1,\"tid\":%u,\"name\":\"thread_name\","
+                            "\"args\":{\"name\":\"job %u\"}},\n", i + 1, i + 1);
+  
+  g_string_append (trace, "{\"ph\":\"M\",\"pid\":1,\"name\":\"process_name\","
+                          "\"args\":{\"name\":\"make\"}}\n]}\n");
+  
+  result = g_file_set_contents (trace_path, trace->str, trace->len, error);
+  
+  g_string_free (trace, TRUE);
+  g_array_free (lanes, TRUE);
+  g_ptr_array_free (records, TRUE);
+  
+  return result;
+}
+
+/*
+ * Returns the records of the recipes that did real work, leaving out 
+ * the ones whose wrapper was the parent of another record.
+ */
+static GPtrArray*
+read_records (const gchar *log_path)
+{
+  gchar *contents;
+  gchar **lines;
+  gchar **line;
+  GHashTable *parents;
+  GPtrArray *records;
+  
+  if (!g_file_get_contents (log_path, &contents, NULL, NULL))
+    return NULL;
+  
+  lines = g_strsplit (contents, "\n", -1);
+  g_free (contents);
+  
+  parents = g_hash_table_new_full (g_str_hash, g_str_equal, g_free, NULL);
+  for (line = lines; *line != NULL; line++)
+    {
+      gchar **fields;
+      fields = g_strsplit (*line, " ", 5);
+      if (g_strv_length (fields) == 5)
+        g_hash_table_add (parents, g_strdup (fields[3]));
+      g_strfreev (fields);
+    }
+  
+  records = g_ptr_array_new_with_free_func ((GDestroyNotify) free_record);
+  
+  for (line = lines; *line != NULL; line++)
+    {
+      gchar **fields;
+      Record *record;
+      
+      fields = g_strsplit (*line, " ", 5);
+      if (g_strv_length (fields) == 5 && !g_hash_table_contains (parents, fields[2]))
+        {
+          record = g_malloc (sizeof (Record));
+          record->start = g_ascii_strtod (fields[0], NULL);
+          record->end = g_ascii_strtod (fields[1], NULL);
+          record->target = g_strdup (fields[4]);
+          g_ptr_array_add (records, record);
+        }
+      g_strfreev (fields);
+    }
+  
+  g_strfreev (lines);
+  g_hash_table_destroy (parents);
+  
+  if (records->len == 0)
+    {
+      g_ptr_array_free (records, TRUE);
+      return NULL;
+    }
+  
+  return records;
+}
+
+static void
+append_json_string (GString     *string,
+                    const gchar *text)
+{
+  const gchar *p;
+  
+  g_string_append_c (string, '"');
+  for (p = text; *p != '\0'; p++)
+    {
+      if (*p == '"' || *p == '\\')
+        g_string_append_printf (string, "\\%c", *p);
+      else if ((guchar) *p < 0x20)
+        g_string_append_printf (string, "\\u%04x", (guint) *p);
+      else
+        g_string_append_c (string, *p);
+    }
+  g_string_append_c (string, '"');
+}
+
+static gint
+compare_records (Record **record1, 
+                 Record **record2)
+{
+  if ((*record1)->start < (*record2)->start)
+    return -1;
+  if ((*record1)->start > (*record2)->start)
+    return 1;
+  return 0;
+}
+
+static gint
+compare_timings (Timing **timing1, 
+                 Timing **timing2)
+{
+  if ((*timing1)->duration > (*timing2)->duration)
+    return -1;
+  if ((*timing1)->duration < (*timing2)->duration)
+    return 1;
+  return 0;
+}
+
+static void
+free_record (Record *record)
+{
+  g_free (record->target);
+  g_free (record);
+}
+
+static void
+free_timing (Timing *timing)
+{
+  g_free (timing->target);
+  g_free (timing);
+}
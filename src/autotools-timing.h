@@ -0,0 +1,38 @@
+/*
+ * Copyright (C) 2010 - Jeff Johnston
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+ */
+
+#ifndef __AUTOTOOLS_TIMING_H__
+#define	__AUTOTOOLS_TIMING_H__
+
+#include <glib.h>
+
+G_BEGIN_DECLS
+
+#define AUTOTOOLS_TIMING_LOG ".codeslayer-timing.log"
+#define AUTOTOOLS_TIMING_TRACE "codeslayer-trace.json"
+
+const gchar*  autotools_timing_get_shell    (void);
+gchar*        autotools_timing_get_report   (const gchar  *log_path,
+                                             gint          count);
+gboolean      autotools_timing_write_trace  (const gchar  *log_path,
+                                             const gchar  *trace_path,
+                                             GError      **error);
+
+G_END_DECLS
+
+#endif /* __AUTOTOOLS_TIMING_H__ */